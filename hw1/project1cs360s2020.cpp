@@ -3,12 +3,34 @@
 #include <string>
 #include <utility>
 #include <vector>
-#include <queue>
-#include <unordered_map>
-#include <unordered_set>
 #include <sstream>
 #include <iomanip>
 #include <fstream>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <functional>
+#include <memory>
+#include <limits>
+#include <new>
+#include <chrono>
+#include <filesystem>
+#include <condition_variable>
+#include <random>
+#include <charconv>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
 
 using namespace std;
 
@@ -17,269 +39,2503 @@ using Action = pair<int, int>;
 using Drone = pair<int, int>;
 using Coord = pair<int, int>;
 
-// #define DEBUG
+/* Random 64-bit key for every cell. The key of a set of placements is the
+ * xor of its cells' keys, so placing a drone updates it with one xor. */
+class ZobristKeys {
+public:
+    ZobristKeys(int n = 0, uint64_t seed = 0x2545f4914f6cdd1dULL) : n(n), keys(n * n) {
+        for(uint64_t &key : keys) {
+            // splitmix64
+            seed += 0x9e3779b97f4a7c15ULL;
+            uint64_t z = seed;
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+            key = z ^ (z >> 31);
+        }
+    }
+
+    uint64_t get(int i, int j) const {
+        return keys[i * n + j];
+    }
 
-struct CoordHash {
-    size_t operator()(const Coord &coord) const {
-        return hash<int>()(coord.first) ^ hash<int>()(coord.second);
+    uint64_t step(uint64_t key, Action action) const {
+        return key ^ get(action.first, action.second);
     }
+
+
+
+private:
+    int n;
+    vector<uint64_t> keys;
 };
 
-struct StateHash {
-    size_t operator()(const State &state) const {
-        size_t x = state.size();
-        for(Coord coord : state) {
-            x ^= CoordHash()(coord) + 0x9e3779b9 + (x << 6) + (x >> 2);
+/* Open-addressing hash set of Zobrist keys, probing linearly. Every path to
+ * a set of placements collects the same packages, so A* only needs to know
+ * whether a state was seen, not which node it was. A slot holding 0 is empty;
+ * key 0, the empty board, is kept in a flag of its own. */
+class TranspositionTable {
+public:
+    TranspositionTable(int capacity = 1024) : numEntries(0), hasZero(false) {
+        int size = 1;
+        while(size < 2 * capacity) {
+            size <<= 1;
+        }
+        keys = vector<uint64_t>(size, 0);
+    }
+
+    /* Insert a key unless it is already present; returns whether it was new. */
+    bool insert(uint64_t key) {
+        if(key == 0) {
+            if(hasZero) {
+                return false;
+            }
+            hasZero = true;
+            numEntries++;
+            return true;
+        }
+        if(2 * (numEntries + 1) > keys.size()) {
+            grow();
+        }
+        size_t mask = keys.size() - 1;
+        for(size_t slot = getSlot(key); ; slot = (slot + 1) & mask) {
+            if(keys[slot] == 0) {
+                keys[slot] = key;
+                numEntries++;
+                return true;
+            }
+            if(keys[slot] == key) {
+                return false;
+            }
+        }
+    }
+
+    size_t size() {
+        return numEntries;
+    }
+
+    long long getMemoryUsage() {
+        return keys.size() * sizeof(uint64_t);
+    }
+
+private:
+    vector<uint64_t> keys;
+    size_t numEntries;
+    bool hasZero;
+
+    size_t getSlot(uint64_t key) {
+        return (key ^ (key >> 32)) & (keys.size() - 1);
+    }
+
+    void grow() {
+        vector<uint64_t> old(2 * keys.size(), 0);
+        old.swap(keys);
+        numEntries = hasZero ? 1 : 0;
+        for(uint64_t key : old) {
+            if(key != 0) {
+                insert(key);
+            }
         }
-        return x;
     }
 };
 
-class Problem {
-public:
-    virtual vector<Action> actions(State state) = 0;
-    virtual State step(State state, Action action) = 0;
-    virtual int solve() = 0;
-    virtual int getNumPackagesCollected(State state) = 0;
-    virtual int getNumEligiblePackages(State state) = 0;
-    virtual string getStateString(State state) = 0;
-    virtual const int getN() = 0;
-    virtual const int getD() = 0;
-    virtual const int getXY(Coord coord) = 0;
+/* Fixed-width bit set of B bits stored in 64-bit words. */
+template<int B>
+struct Bits {
+    static const int NUM_WORDS = (B + 63) / 64;
+    uint64_t words[NUM_WORDS];
+
+    Bits() {
+        clear();
+    }
+
+    void clear() {
+        for(int w = 0; w < NUM_WORDS; w++) {
+            words[w] = 0;
+        }
+    }
+
+    void set(int k) {
+        words[k >> 6] |= uint64_t(1) << (k & 63);
+    }
+
+
+
+    bool test(int k) const {
+        return (words[k >> 6] >> (k & 63)) & 1;
+    }
+
+    /* Set the lowest k bits. */
+    void setPrefix(int k) {
+        for(int w = 0; w < NUM_WORDS; w++) {
+            int numBits = min(64, max(0, k - 64 * w));
+            words[w] = (numBits == 64) ? ~uint64_t(0) : ((uint64_t(1) << numBits) - 1);
+        }
+    }
+
+    /* Bits [offset, offset + R) as a R-bit set. */
+    template<int R>
+    Bits<R> window(int offset) const {
+        Bits<R> res;
+        int q = offset >> 6;
+        int r = offset & 63;
+        for(int w = 0; w < Bits<R>::NUM_WORDS; w++) {
+            uint64_t lo = (q + w < NUM_WORDS) ? words[q + w] : 0;
+            uint64_t hi = (r != 0 && q + w + 1 < NUM_WORDS) ? words[q + w + 1] : 0;
+            res.words[w] = (lo >> r) | (r != 0 ? (hi << (64 - r)) : 0);
+        }
+        return res;
+    }
+
+    Bits& operator|=(const Bits &other) {
+        for(int w = 0; w < NUM_WORDS; w++) {
+            words[w] |= other.words[w];
+        }
+        return *this;
+    }
+
+    Bits& operator&=(const Bits &other) {
+        for(int w = 0; w < NUM_WORDS; w++) {
+            words[w] &= other.words[w];
+        }
+        return *this;
+    }
+
+    Bits operator~() const {
+        Bits res;
+        for(int w = 0; w < NUM_WORDS; w++) {
+            res.words[w] = ~words[w];
+        }
+        return res;
+    }
+
+
+
+    /* Index of the first set bit at or after k, or B if there is none. */
+    int findNext(int k) const {
+        int w = k >> 6;
+        if(w >= NUM_WORDS) return B;
+        uint64_t x = words[w] & (~uint64_t(0) << (k & 63));
+        while(true) {
+            if(x != 0) {
+                return min(B, 64 * w + __builtin_ctzll(x));
+            }
+            if(++w == NUM_WORDS) return B;
+            x = words[w];
+        }
+    }
 };
 
-class Solver {
-public:
-    Solver(Problem *problem) : problem(problem) {}
+/* Row, column and diagonal coverage of a board of width at most W.
+ * The diagonal of (i, j) with constant i - j is stored at j - i + W - 1 and the
+ * one with constant i + j at i + j, so that both line up with the columns of
+ * row i after a shift. */
+template<int W>
+struct Coverage {
+    Bits<W> rows;
+    Bits<W> cols;
+    Bits<2 * W> diag1;
+    Bits<2 * W> diag2;
+
+    void place(int i, int j) {
+        rows.set(i);
+        cols.set(j);
+        diag1.set(j - i + W - 1);
+        diag2.set(i + j);
+    }
 
-    virtual int solve() = 0;
+    bool covered(int i, int j) const {
+        return rows.test(i) || cols.test(j)
+            || diag1.test(j - i + W - 1) || diag2.test(i + j);
+    }
 
-protected:
-    Problem* problem;
+    /* Columns of row i that are not covered, restricted to boardMask. */
+    Bits<W> uncoveredInRow(int i, const Bits<W> &boardMask) const {
+        if(rows.test(i)) {
+            return Bits<W>();
+        }
+        Bits<W> res = cols;
+        res |= diag1.template window<W>(W - 1 - i);
+        res |= diag2.template window<W>(i);
+        res = ~res;
+        res &= boardMask;
+        return res;
+    }
+};
+
+/* Allocator for storage that starts on its own cache line. */
+template<typename T, size_t ALIGNMENT = 64>
+struct AlignedAllocator {
+    using value_type = T;
+
+    template<typename U>
+    struct rebind {
+        using other = AlignedAllocator<U, ALIGNMENT>;
+    };
+
+    AlignedAllocator() {}
+
+    template<typename U>
+    AlignedAllocator(const AlignedAllocator<U, ALIGNMENT> &) {}
+
+    T* allocate(size_t count) {
+        return static_cast<T*>(::operator new(count * sizeof(T), align_val_t(ALIGNMENT)));
+    }
+
+    void deallocate(T* p, size_t) {
+        ::operator delete(p, align_val_t(ALIGNMENT));
+    }
+
+    bool operator==(const AlignedAllocator &) const {
+        return true;
+    }
+
+    bool operator!=(const AlignedAllocator &) const {
+        return false;
+    }
+};
+
+/* The eight symmetries of the square board. Each maps rows, columns and
+ * the two diagonal families onto lines, so coverage is preserved. */
+enum Symmetry {
+    IDENTITY,
+    ROTATE_90,
+    ROTATE_180,
+    ROTATE_270,
+    MIRROR_ROWS, // i -> n - 1 - i
+    MIRROR_COLS, // j -> n - 1 - j
+    TRANSPOSE, // (i, j) -> (j, i)
+    ANTI_TRANSPOSE, // (i, j) -> (n - 1 - j, n - 1 - i)
+    NUM_SYMMETRIES
 };
 
-class DfsSolver : public Solver {
+Coord transform(Symmetry symmetry, Coord coord, int n) {
+    int i = coord.first;
+    int j = coord.second;
+    switch(symmetry) {
+        case ROTATE_90: return make_pair(j, n - 1 - i);
+        case ROTATE_180: return make_pair(n - 1 - i, n - 1 - j);
+        case ROTATE_270: return make_pair(n - 1 - j, i);
+        case MIRROR_ROWS: return make_pair(n - 1 - i, j);
+        case MIRROR_COLS: return make_pair(i, n - 1 - j);
+        case TRANSPOSE: return make_pair(j, i);
+        case ANTI_TRANSPOSE: return make_pair(n - 1 - j, n - 1 - i);
+        default: return coord;
+    }
+}
+
+/* Package counts of an n x n board in one contiguous, cache-aligned row-major
+ * array, with per-row prefix sums for line queries. */
+class PackageGrid {
 public:
-    DfsSolver(Problem* problem) : Solver(problem), numPlaced(0), 
-                numPackagesCollected(0), numExpansions(0) {
-        n = problem -> getN();
-        d = problem -> getD();
-        packages = vector< vector<int> >(n, vector<int>(n, 0));
-        rowHistory.push_back(0);
-        colHistory.push_back(0);
-        diag1History.push_back(0);
-        diag2History.push_back(0);
-        placed = vector< vector<bool> >(n, vector<bool>(n, false));
+    PackageGrid(int n = 0) : n(n), cells(n * n, 0), rowPrefix(n * (n + 1), 0) {}
+
+    /* Grid with the given row-major counts. */
+    PackageGrid(int n, const vector<int> &counts) : n(n), cells(counts.begin(), counts.end()),
+                rowPrefix(n * (n + 1), 0) {
         for(int i = 0; i < n; i++) {
             for(int j = 0; j < n; j++) {
-                packages[i][j] = problem -> getXY(make_pair(i,j));
-                if(packages[i][j] > 0) {
-                    packagesList.push_back(make_pair(i,j));
+                rowPrefix[i * (n + 1) + j + 1] = rowPrefix[i * (n + 1) + j] + get(i, j);
+            }
+        }
+    }
+
+    int getN() const {
+        return n;
+    }
+
+    int get(int i, int j) const {
+        return cells[i * n + j];
+    }
+
+    /* Packages on columns [from, to) of row i. */
+    int getRowSum(int i, int from, int to) const {
+        return rowPrefix[i * (n + 1) + to] - rowPrefix[i * (n + 1) + from];
+    }
+
+    const int* getRow(int i) const {
+        return cells.data() + i * n;
+    }
+
+    /* Symmetries that map every cell onto one with the same count. */
+    vector<Symmetry> getSymmetries() const {
+        vector<Symmetry> symmetries;
+        for(int s = IDENTITY; s < NUM_SYMMETRIES; s++) {
+            Symmetry symmetry = (Symmetry) s;
+            bool invariant = true;
+            for(int i = 0; i < n && invariant; i++) {
+                for(int j = 0; j < n && invariant; j++) {
+                    Coord image = transform(symmetry, make_pair(i, j), n);
+                    invariant = get(i, j) == get(image.first, image.second);
                 }
             }
+            if(invariant) {
+                symmetries.push_back(symmetry);
+            }
         }
-        optSoFar = 0;
+        return symmetries;
     }
-    
-    int solve() {
-        #ifdef DEBUG
-        cout << problem->getStateString(history) << endl;
-        #endif
 
-        numExpansions++;
+private:
+    int n;
+    vector< int, AlignedAllocator<int> > cells;
+    vector< int, AlignedAllocator<int> > rowPrefix;
+};
 
-        if(numPlaced == d) {
-            return numPackagesCollected;
+/* Sum of the k largest of count non-negative values. The k-th largest is
+ * found a bit at a time, from the top bit of the maximum down, with one
+ * compare-and-count pass over the values per bit; a last pass adds up what
+ * lies above it. Every pass is branch-free, so it maps onto SIMD lanes. */
+int getTopSumScalar(const int *values, int count, int k) {
+    int maxValue = 0;
+    int total = 0;
+    int numPositive = 0;
+    for(int i = 0; i < count; i++) {
+        maxValue = max(maxValue, values[i]);
+        total += values[i];
+        numPositive += values[i] > 0;
+    }
+    if(k >= numPositive) {
+        return total;
+    }
+
+    int threshold = 0;
+    for(int bit = 31 - __builtin_clz(maxValue); bit >= 0; bit--) {
+        int candidate = threshold | (1 << bit);
+        int numAtLeast = 0;
+        for(int i = 0; i < count; i++) {
+            numAtLeast += values[i] >= candidate;
+        }
+        if(numAtLeast >= k) {
+            threshold = candidate;
         }
+    }
 
-        int opt = 0;
+    int sumAbove = 0;
+    int numAbove = 0;
+    for(int i = 0; i < count; i++) {
+        bool above = values[i] > threshold;
+        sumAbove += above ? values[i] : 0;
+        numAbove += above;
+    }
+    return sumAbove + (k - numAbove) * threshold;
+}
 
-        int upperBound = numPackagesCollected + getOverestimation();
-        if(upperBound <= optSoFar) {
-            return 0;
+#if defined(__x86_64__) || defined(__i386__)
+__attribute__((target("avx2")))
+int getLaneSum(__m256i lanes) {
+    __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(lanes), _mm256_extracti128_si256(lanes, 1));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(sum);
+}
+
+__attribute__((target("avx2")))
+int getLaneMax(__m256i lanes) {
+    __m128i res = _mm_max_epi32(_mm256_castsi256_si128(lanes), _mm256_extracti128_si256(lanes, 1));
+    res = _mm_max_epi32(res, _mm_shuffle_epi32(res, _MM_SHUFFLE(1, 0, 3, 2)));
+    res = _mm_max_epi32(res, _mm_shuffle_epi32(res, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(res);
+}
+
+/* getTopSumScalar eight values at a time. Comparisons give -1 in the lanes
+ * that hold, so counts are kept by subtracting them. */
+__attribute__((target("avx2")))
+int getTopSumAvx2(const int *values, int count, int k) {
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i maxLanes = zero;
+    __m256i totalLanes = zero;
+    __m256i positiveLanes = zero;
+    int end = count & ~7;
+    for(int i = 0; i < end; i += 8) {
+        __m256i v = _mm256_loadu_si256((const __m256i*) (values + i));
+        maxLanes = _mm256_max_epi32(maxLanes, v);
+        totalLanes = _mm256_add_epi32(totalLanes, v);
+        positiveLanes = _mm256_sub_epi32(positiveLanes, _mm256_cmpgt_epi32(v, zero));
+    }
+    int maxValue = getLaneMax(maxLanes);
+    int total = getLaneSum(totalLanes);
+    int numPositive = getLaneSum(positiveLanes);
+    for(int i = end; i < count; i++) {
+        maxValue = max(maxValue, values[i]);
+        total += values[i];
+        numPositive += values[i] > 0;
+    }
+    if(k >= numPositive) {
+        return total;
+    }
+
+    int threshold = 0;
+    for(int bit = 31 - __builtin_clz(maxValue); bit >= 0; bit--) {
+        int candidate = threshold | (1 << bit);
+        // v >= candidate is v > candidate - 1
+        __m256i below = _mm256_set1_epi32(candidate - 1);
+        __m256i atLeastLanes = zero;
+        for(int i = 0; i < end; i += 8) {
+            __m256i v = _mm256_loadu_si256((const __m256i*) (values + i));
+            atLeastLanes = _mm256_sub_epi32(atLeastLanes, _mm256_cmpgt_epi32(v, below));
         }
+        int numAtLeast = getLaneSum(atLeastLanes);
+        for(int i = end; i < count; i++) {
+            numAtLeast += values[i] >= candidate;
+        }
+        if(numAtLeast >= k) {
+            threshold = candidate;
+        }
+    }
 
-        int startingRow = (history.empty()) ? 0 : (history[history.size() - 1].first + 1);
-        int endRow = n - (d - numPlaced);
-        for(int i = startingRow; i <= endRow; i++) {
+    __m256i thresholdLanes = _mm256_set1_epi32(threshold);
+    __m256i sumLanes = zero;
+    __m256i aboveLanes = zero;
+    for(int i = 0; i < end; i += 8) {
+        __m256i v = _mm256_loadu_si256((const __m256i*) (values + i));
+        __m256i above = _mm256_cmpgt_epi32(v, thresholdLanes);
+        sumLanes = _mm256_add_epi32(sumLanes, _mm256_and_si256(v, above));
+        aboveLanes = _mm256_sub_epi32(aboveLanes, above);
+    }
+    int sumAbove = getLaneSum(sumLanes);
+    int numAbove = getLaneSum(aboveLanes);
+    for(int i = end; i < count; i++) {
+        bool above = values[i] > threshold;
+        sumAbove += above ? values[i] : 0;
+        numAbove += above;
+    }
+    return sumAbove + (k - numAbove) * threshold;
+}
+#endif
+
+/* The top-k kernel for this CPU, picked once at startup. */
+int (*selectTopSumKernel())(const int*, int, int) {
+    #if defined(__x86_64__) || defined(__i386__)
+    if(__builtin_cpu_supports("avx2")) {
+        return getTopSumAvx2;
+    }
+    #endif
+    return getTopSumScalar;
+}
+
+int (*const topSumKernel)(const int*, int, int) = selectTopSumKernel();
+
+/* Upper bound on the packages the remaining drones can still collect. Every
+ * drone needs its own row, column and diagonals, so for each of the four line
+ * families the k remaining drones collect at most the k largest per-line
+ * maxima over uncovered cells; the bound is the smallest of the four sums.
+ * Line maxima are kept up to date as drones are placed, so placing one drone
+ * only revisits the package cells on its own four lines. */
+class EligibleBound {
+public:
+    static const int NUM_FAMILIES = 4; // rows, columns, diag1 (i - j), diag2 (i + j)
+
+    EligibleBound() : n(0) {}
+
+    EligibleBound(const PackageGrid &packages) : n(packages.getN()) {
+        int numLines = 6 * n - 2;
+        shared_ptr< vector< vector<Cell> > > cells(new vector< vector<Cell> >(numLines));
+        for(int i = 0; i < n; i++) {
+            if(packages.getRowSum(i, 0, n) == 0) {
+                continue;
+            }
+            const int* row = packages.getRow(i);
             for(int j = 0; j < n; j++) {
-                if(!getCovered(i,j)) {
-                    // stepping
-                    step(make_pair(i,j));
-                    opt = max(opt, solve());
-                    unstep(make_pair(i,j));
-                    if(opt > optSoFar) {
-                        optSoFar = opt;
+                if(row[j] > 0) {
+                    int lines[NUM_FAMILIES];
+                    getLines(i, j, lines);
+                    for(int line : lines) {
+                        (*cells)[line].push_back({row[j], i, j});
                     }
-                    if(opt == upperBound) {
-                        return opt;
+                }
+            }
+        }
+        for(vector<Cell> &line : *cells) {
+            stable_sort(line.begin(), line.end(), [](const Cell &c1, const Cell &c2) {
+                return c1.count > c2.count;
+            });
+        }
+        lineCells = cells;
+        lineCovered = vector<char>(numLines, 0);
+        heads = vector<int>(numLines, 0);
+        lineMax = vector<int>(numLines, 0);
+        for(int line = 0; line < numLines; line++) {
+            refresh(line);
+        }
+    }
+
+    /* Cover the four lines through (x, y). */
+    void place(int x, int y) {
+        int lines[NUM_FAMILIES];
+        getLines(x, y, lines);
+        for(int line : lines) {
+            lineCovered[line] = 1;
+            lineMax[line] = 0;
+        }
+        for(int line : lines) {
+            for(const Cell &cell : (*lineCells)[line]) {
+                int cellLines[NUM_FAMILIES];
+                getLines(cell.i, cell.j, cellLines);
+                for(int cellLine : cellLines) {
+                    if(!lineCovered[cellLine]) {
+                        refresh(cellLine);
                     }
                 }
             }
         }
+    }
 
-        return opt;
+    bool covered(int i, int j) {
+        int lines[NUM_FAMILIES];
+        getLines(i, j, lines);
+        return lineCovered[lines[0]] || lineCovered[lines[1]]
+            || lineCovered[lines[2]] || lineCovered[lines[3]];
     }
 
-    int getNumExpansions() {
-        return numExpansions;
+    int getBound(int numDronesLeft) {
+        if(numDronesLeft <= 0) {
+            return 0;
+        }
+        int res = numeric_limits<int>::max();
+        for(int family = 0; family < NUM_FAMILIES; family++) {
+            res = min(res, getTopSum(family, numDronesLeft));
+        }
+        return res;
     }
 
 private:
-    vector< vector<int> > packages;
-    vector<int> rowHistory;
-    vector<int> colHistory;
-    vector<int> diag1History;
-    vector<int> diag2History;
-    vector< vector<bool> > placed;
-    vector< Action > history;
-    vector< Coord > packagesList;
-    int n;
-    int d;
-    int numPlaced;
-    int numPackagesCollected;
-    int numExpansions;
-    int optSoFar;
+    struct Cell {
+        int count;
+        int i;
+        int j;
+    };
 
-    void step(Action action) {
-        // create new cover ints
-        int rowCoverage = rowHistory[rowHistory.size() - 1];
-        rowCoverage |= 1 << action.first;
-        rowHistory.push_back(rowCoverage);
-
-        int colCoverage = colHistory[colHistory.size() - 1];
-        colCoverage |= 1 << action.second;
-        colHistory.push_back(colCoverage);
-
-        int diag1Coverage = diag1History[diag1History.size() - 1];
-        diag1Coverage |= 1 << (action.first - action.second + n - 1);
-        diag1History.push_back(diag1Coverage);
-
-        int diag2Coverage = diag2History[diag2History.size() - 1];
-        diag2Coverage |= 1 << (action.first + action.second);
-        diag2History.push_back(diag2Coverage);
-        
-        // update drone matrix
-        placed[action.first][action.second] = true;
+    int n;
+    // package cells of every line, most packages first; shared between copies
+    shared_ptr< const vector< vector<Cell> > > lineCells;
+    vector<char> lineCovered;
+    vector<int> heads; // first cell of each line that may still be uncovered
+    vector<int> lineMax;
+
+    void getLines(int i, int j, int lines[NUM_FAMILIES]) {
+        lines[0] = i;
+        lines[1] = n + j;
+        lines[2] = 2 * n + (i - j + n - 1);
+        lines[3] = 4 * n - 1 + (i + j);
+    }
 
-        // update history
-        history.push_back(action);
+    int getFamilyBegin(int family) {
+        int begins[NUM_FAMILIES + 1] = {0, n, 2 * n, 4 * n - 1, 6 * n - 2};
+        return begins[family];
+    }
 
-        // update numPlaced
-        numPlaced++;
+    void refresh(int line) {
+        const vector<Cell> &cells = (*lineCells)[line];
+        while(heads[line] < (int) cells.size() && covered(cells[heads[line]].i, cells[heads[line]].j)) {
+            heads[line]++;
+        }
+        lineMax[line] = (heads[line] < (int) cells.size()) ? cells[heads[line]].count : 0;
+    }
 
-        // update numPackagesCollected
-        numPackagesCollected += packages[action.first][action.second];
+    /* Sum of the k largest line maxima of a family. */
+    int getTopSum(int family, int k) {
+        int begin = getFamilyBegin(family);
+        int end = getFamilyBegin(family + 1);
+        return topSumKernel(lineMax.data() + begin, end - begin, k);
     }
+};
 
-    void unstep(Action action) {
-        rowHistory.pop_back();
-        colHistory.pop_back();
-        diag1History.pop_back();
-        diag2History.pop_back();
+/* Upper bound from relaxing the placement to an assignment: the remaining
+ * drones go to distinct rows and distinct columns on uncovered cells, and the
+ * diagonals are ignored. This is a maximum-weight matching between rows and
+ * columns, solved by successive longest augmenting paths. Each augmentation
+ * adds one drone and the gains never increase, so the search can stop early
+ * once the outcome against a pruning target is known. */
+class AssignmentBound {
+public:
+    AssignmentBound() : n(0) {}
 
-        placed[action.first][action.second] = false;
+    AssignmentBound(const PackageGrid &packages) : n(packages.getN()) {
+        rowBegin = vector<int>(n + 1, 0);
+        for(int i = 0; i < n; i++) {
+            const int* row = packages.getRow(i);
+            for(int j = 0; j < n; j++) {
+                if(row[j] > 0) {
+                    cells.push_back({i, j, row[j]});
+                }
+            }
+            rowBegin[i + 1] = cells.size();
+        }
+    }
 
-        history.pop_back();
+    /* Best total of at most k uncovered cells in rows >= firstRow with
+     * distinct rows and columns, never more than cap. With target >= 0 it
+     * stops once the total is known to be above target (returning cap) or at
+     * most target. */
+    template<typename Covered>
+    int getBound(const Covered &covered, int firstRow, int k, int cap, int target = -1) {
+        edges.clear();
+        for(int e = rowBegin[min(firstRow, n)]; e < (int) cells.size(); e++) {
+            if(!covered(cells[e].i, cells[e].j)) {
+                edges.push_back(cells[e]);
+            }
+        }
+        rowMatch.assign(n, -1);
+        colMatch.assign(n, -1);
+        matchWeight.assign(n, 0);
+        matching.clear();
+
+        int total = 0;
+        for(int t = 0; t < k; t++) {
+            int gain = augment();
+            if(gain <= 0) {
+                break;
+            }
+            total += gain;
+            if(target >= 0) {
+                // later augmentations gain at most this one did
+                int upper = total + (k - t - 1) * gain;
+                if(upper <= target) {
+                    collectMatching();
+                    return min(cap, upper);
+                }
+                if(total > target) {
+                    collectMatching();
+                    return cap;
+                }
+            }
+        }
+        collectMatching();
+        return min(cap, total);
+    }
 
-        numPlaced--;
+    /* Cells of the matching found by the last call to getBound. */
+    const vector<Coord>& getMatching() {
+        return matching;
+    }
 
-        numPackagesCollected -= packages[action.first][action.second];
+    /* Total of the k heaviest cells of an earlier matching that are still
+     * uncovered in rows >= firstRow, a lower bound on the assignment. The
+     * cells used are kept in kept. */
+    template<typename Covered>
+    int getMatchingWeight(const vector<Coord> &earlier, const Covered &covered,
+                int firstRow, int k, vector<Coord> &kept, const PackageGrid &packages) {
+        kept.clear();
+        for(Coord coord : earlier) {
+            if(coord.first >= firstRow && !covered(coord.first, coord.second)) {
+                kept.push_back(coord);
+            }
+        }
+        if((int) kept.size() > k) {
+            nth_element(kept.begin(), kept.begin() + k, kept.end(), [&packages](Coord c1, Coord c2) {
+                return packages.get(c1.first, c1.second) > packages.get(c2.first, c2.second);
+            });
+            kept.resize(k);
+        }
+        int res = 0;
+        for(Coord coord : kept) {
+            res += packages.get(coord.first, coord.second);
+        }
+        return res;
     }
 
-    bool getCovered(int i, int j) {
-        bool covered = false;
-        covered |= (rowHistory[rowHistory.size() - 1] >> i) & 1;
-        covered |= (colHistory[colHistory.size() - 1] >> j) & 1;
-        covered |= (diag1History[diag1History.size() - 1] >> (i - j + n - 1)) & 1;
-        covered |= (diag2History[diag2History.size() - 1] >> (i + j)) & 1;
-        return covered;
+private:
+    struct Cell {
+        int i;
+        int j;
+        int count;
+    };
+
+    int n;
+    vector<Cell> cells; // package cells in row-major order
+    vector<int> rowBegin; // first cell of every row
+    vector<Cell> edges;
+    vector<int> rowMatch;
+    vector<int> colMatch;
+    vector<int> matchWeight; // weight of the matched cell of each column
+    vector<int> rowDist;
+    vector<int> colDist;
+    vector<int> colPrev; // row the best path to each column came from
+    vector<int> colPrevWeight;
+    vector<Coord> matching;
+
+    /* Apply the augmenting path of largest gain and return the gain, or 0 if
+     * no path gains anything. */
+    int augment() {
+        const int NONE = numeric_limits<int>::min() / 2;
+        rowDist.assign(n, NONE);
+        colDist.assign(n, NONE);
+        colPrev.assign(n, -1);
+        colPrevWeight.assign(n, 0);
+        for(const Cell &edge : edges) {
+            if(rowMatch[edge.i] < 0) {
+                rowDist[edge.i] = 0;
+            }
+        }
+        // Bellman-Ford; the matching is optimal for its size, so there are no
+        // positive cycles
+        bool changed = true;
+        while(changed) {
+            changed = false;
+            for(const Cell &edge : edges) {
+                if(rowMatch[edge.i] != edge.j && rowDist[edge.i] != NONE
+                    && rowDist[edge.i] + edge.count > colDist[edge.j]) {
+                    colDist[edge.j] = rowDist[edge.i] + edge.count;
+                    colPrev[edge.j] = edge.i;
+                    colPrevWeight[edge.j] = edge.count;
+                    changed = true;
+                }
+            }
+            for(int j = 0; j < n; j++) {
+                int i = colMatch[j];
+                if(i >= 0 && colDist[j] != NONE && colDist[j] - matchWeight[j] > rowDist[i]) {
+                    rowDist[i] = colDist[j] - matchWeight[j];
+                    changed = true;
+                }
+            }
+        }
+
+        int bestCol = -1;
+        for(int j = 0; j < n; j++) {
+            if(colMatch[j] < 0 && colDist[j] != NONE
+                && (bestCol < 0 || colDist[j] > colDist[bestCol])) {
+                bestCol = j;
+            }
+        }
+        if(bestCol < 0 || colDist[bestCol] <= 0) {
+            return 0;
+        }
+
+        int gain = colDist[bestCol];
+        int j = bestCol;
+        while(j >= 0) {
+            int i = colPrev[j];
+            int nextCol = rowMatch[i];
+            rowMatch[i] = j;
+            colMatch[j] = i;
+            matchWeight[j] = colPrevWeight[j];
+            j = nextCol;
+        }
+        return gain;
     }
 
-    int getOverestimation() { // O(num of packages)
-        int res = 0;
-        for(Coord coord : packagesList) {
-            int i = coord.first;
-            int j = coord.second;
-            if(!getCovered(i, j)) {
-                res += packages[i][j];
+    void collectMatching() {
+        for(int j = 0; j < n; j++) {
+            if(colMatch[j] >= 0) {
+                matching.push_back(make_pair(colMatch[j], j));
             }
         }
-        return res;
     }
 };
 
-class AstarSolver : public Solver {
+/* Fixed-size thread pool. Each worker drains its own deque from the front and,
+ * once it runs dry, steals from the back of the other workers' deques, and
+ * sleeps when there is nothing to steal until a task is submitted or the last
+ * one finishes. Tasks receive the index of the worker running them and may
+ * submit more tasks. */
+class WorkStealingPool {
 public:
-    AstarSolver(Problem* problem) : Solver(problem) {}
+    using Task = function<void(int)>;
 
-    int solve() {
-        State initState;
-        auto comp = [this](State s1, State s2) {
-            int g1 = problem->getNumPackagesCollected(s1);
-            int g2 = problem->getNumPackagesCollected(s2);
-            int f1 = g1 + heuristic(s1);
-            int f2 = g2 + heuristic(s2);
-            if(f1 != f2) {
-                return f1 < f2;
-            }
-            return g1 < g2;
-        };
-        priority_queue<State, vector<State>, decltype(comp)> frontier(comp);
-        frontier.push(initState);
-        unordered_set<State, StateHash> frontierSet;
-        unordered_set<State, StateHash> explored;
-        while(true) {
-            if(frontier.empty()) {
-                // failure
-                return 0;
-            }
-            State state = frontier.top();
-            frontier.pop();
-            frontierSet.erase(state);
+    WorkStealingPool(int numThreads) : queues(max(1, numThreads)),
+                locks(max(1, numThreads)), pending(0), queued(0), nextQueue(0) {}
+
+    int getNumThreads() {
+        return queues.size();
+    }
+
+    void submit(Task task) {
+        submit(task, nextQueue++ % queues.size());
+    }
+
+    void submit(Task task, int worker) {
+        {
+            lock_guard<mutex> guard(locks[worker]);
+            queues[worker].push_back(task);
+            pending++;
+            queued++;
+        }
+        wake(false);
+    }
+
+    /* Run until every submitted task (including ones submitted by tasks) is done. */
+    void run() {
+        vector<thread> threads;
+        for(int worker = 1; worker < getNumThreads(); worker++) {
+            threads.push_back(thread(&WorkStealingPool::work, this, worker));
+        }
+        work(0);
+        for(thread &t : threads) {
+            t.join();
+        }
+    }
+
+private:
+    vector< deque<Task> > queues;
+    vector<mutex> locks;
+    atomic<int> pending; // tasks submitted and not finished
+    atomic<int> queued; // tasks submitted and not started
+    atomic<unsigned int> nextQueue;
+    mutex idleLock;
+    condition_variable idle;
+
+    bool pop(int worker, Task &task) {
+        lock_guard<mutex> guard(locks[worker]);
+        if(queues[worker].empty()) {
+            return false;
+        }
+        task = queues[worker].front();
+        queues[worker].pop_front();
+        queued--;
+        return true;
+    }
+
+    bool steal(int worker, Task &task) {
+        int numThreads = getNumThreads();
+        for(int k = 1; k < numThreads; k++) {
+            int victim = (worker + k) % numThreads;
+            lock_guard<mutex> guard(locks[victim]);
+            if(!queues[victim].empty()) {
+                task = queues[victim].back();
+                queues[victim].pop_back();
+                queued--;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /* Taking the idle lock before notifying means a worker that just found
+     * nothing to do is either already waiting or will see the change. */
+    void wake(bool all) {
+        {
+            lock_guard<mutex> guard(idleLock);
+        }
+        if(all) {
+            idle.notify_all();
+        }
+        else {
+            idle.notify_one();
+        }
+    }
+
+    void work(int worker) {
+        Task task;
+        while(true) {
+            if(pop(worker, task) || steal(worker, task)) {
+                task(worker);
+                if(--pending == 0) {
+                    wake(true);
+                }
+            }
+            else {
+                unique_lock<mutex> guard(idleLock);
+                idle.wait(guard, [this] {
+                    return pending == 0 || queued > 0;
+                });
+                if(pending == 0) {
+                    return;
+                }
+            }
+        }
+    }
+};
+
+/* Settings that may follow the algorithm name in input.txt as key=value
+ * pairs, e.g. "pdfs threads=8 beam=32" or "idastar memory=512". */
+struct SearchOptions {
+    int numThreads = 0; // threads: worker threads for pdfs, 0 for one per core
+    long long memoryBudget = 256; // memory: megabytes of nodes idastar, or of cache memo, may keep
+    int beamWidth = 16; // beam: width of the beam search seeding dfs, 0 to skip it
+    // budget of dfs and pdfs, which then answer with the best placement found
+    double timeLimit = 0; // time: seconds to search, 0 for no limit
+    long long maxExpansions = 0; // nodes: expansions to search, 0 for no limit
+    double progressInterval = 0; // progress: seconds between progress lines, 0 for none
+    bool reportOccupancy = false; // occupancy: 1 to print the A* frontier's f buckets as it grows
+    bool dumpStats = false; // stats: 1 to print the search's counters to stderr as JSON
+    double sampleInterval = 0; // sample: seconds between samples of the counters, 0 for none
+
+    void set(string option) {
+        size_t delimPosition = option.find('=');
+        if(delimPosition == string::npos) {
+            // a bare number is a thread count
+            numThreads = stoi(option);
+            return;
+        }
+        string key = option.substr(0, delimPosition);
+        string value = option.substr(delimPosition + 1);
+        if(key == "threads") {
+            numThreads = stoi(value);
+        }
+        else if(key == "memory") {
+            memoryBudget = stoll(value);
+        }
+        else if(key == "beam") {
+            beamWidth = stoi(value);
+        }
+        else if(key == "time") {
+            timeLimit = stod(value);
+        }
+        else if(key == "nodes") {
+            maxExpansions = stoll(value);
+        }
+        else if(key == "progress") {
+            progressInterval = stod(value);
+        }
+        else if(key == "occupancy") {
+            reportOccupancy = stoi(value) != 0;
+        }
+        else if(key == "stats") {
+            dumpStats = stoi(value) != 0;
+        }
+        else if(key == "sample") {
+            sampleInterval = stod(value);
+        }
+        else {
+            throw invalid_argument("unknown option " + key + ".");
+        }
+    }
+};
+
+/* Guards stderr between the threads of a search, and between the searches
+ * of a batch. Each diagnostic line is formatted on a stream of its own and
+ * written whole, so lines never interleave and cerr's format flags are left
+ * alone. A non-empty label, the input of a batch search, starts the line. */
+mutex errorLock;
+
+void writeError(const string &line, const string &label = "") {
+    lock_guard<mutex> guard(errorLock);
+    if(!label.empty()) {
+        cerr << label << ": ";
+    }
+    cerr << line << endl;
+}
+
+/* Time and expansion budget shared by the solvers of one run. Solvers count
+ * their expansions locally and only call check() every getCheckInterval() of
+ * them, so the hot loop pays for a decrement and a test. */
+class SearchBudget {
+public:
+    SearchBudget(double timeLimit = 0, long long maxExpansions = 0, double progressInterval = 0,
+                string label = "")
+                : timeLimit(timeLimit), maxExpansions(maxExpansions),
+                progressInterval(progressInterval), nextProgress(progressInterval),
+                label(label), numExpansions(0), stopped(false) {
+        start = chrono::steady_clock::now();
+    }
+
+    int getCheckInterval() {
+        return (maxExpansions > 0 && maxExpansions < CHECK_INTERVAL) ? maxExpansions : CHECK_INTERVAL;
+    }
+
+    /* Account for getCheckInterval() more expansions, print a progress line
+     * when one is due and stop once the budget is spent. */
+    void check(int incumbent) {
+        long long expansions = numExpansions += getCheckInterval();
+        chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+        if(progressInterval > 0 && elapsed.count() >= nextProgress.load(memory_order_relaxed)) {
+            lock_guard<mutex> guard(progressLock);
+            if(elapsed.count() >= nextProgress.load(memory_order_relaxed)) {
+                stringstream ss;
+                ss << "progress: " << fixed << setprecision(1) << elapsed.count() << "s, "
+                   << expansions << " expansions, best " << incumbent;
+                writeError(ss.str(), label);
+                nextProgress.store(elapsed.count() + progressInterval, memory_order_relaxed);
+            }
+        }
+        if((maxExpansions > 0 && expansions >= maxExpansions)
+                || (timeLimit > 0 && elapsed.count() >= timeLimit)) {
+            stopped = true;
+        }
+    }
+
+    bool isStopped() {
+        return stopped.load(memory_order_relaxed);
+    }
+
+private:
+    static const int CHECK_INTERVAL = 1024;
+
+    chrono::steady_clock::time_point start;
+    double timeLimit;
+    long long maxExpansions;
+    double progressInterval;
+    atomic<double> nextProgress; // written under progressLock
+    string label; // label of the progress lines
+    mutex progressLock;
+    atomic<long long> numExpansions;
+    atomic<bool> stopped;
+};
+
+/* Totals of a search, as read from its SearchCounters. Times are in
+ * milliseconds; heuristicMs is extrapolated from a sample of the
+ * evaluations, and the rest of searchMs is spent expanding. */
+struct SearchStats {
+    long long numExpansions = 0;
+    long long numPrunes = 0; // subtrees cut off by the bound
+    long long numHeuristicEvals = 0;
+    long long numDuplicates = 0; // children already generated elsewhere
+    long long peakFrontier = 0;
+    long long peakExplored = 0;
+    double searchMs = 0;
+    double heuristicMs = 0;
+
+    /* Add the totals of a search run alongside, e.g. on another thread. */
+    void merge(const SearchStats &other) {
+        numExpansions += other.numExpansions;
+        numPrunes += other.numPrunes;
+        numHeuristicEvals += other.numHeuristicEvals;
+        numDuplicates += other.numDuplicates;
+        peakFrontier += other.peakFrontier;
+        peakExplored += other.peakExplored;
+        searchMs += other.searchMs;
+        heuristicMs += other.heuristicMs;
+    }
+
+    string toJson() const {
+        stringstream ss;
+        ss << "{\"expansions\": " << numExpansions
+           << ", \"prunes\": " << numPrunes
+           << ", \"heuristic_evals\": " << numHeuristicEvals
+           << ", \"duplicates\": " << numDuplicates
+           << ", \"peak_frontier\": " << peakFrontier
+           << ", \"peak_explored\": " << peakExplored
+           << fixed << setprecision(3)
+           << ", \"search_ms\": " << searchMs
+           << ", \"heuristic_ms\": " << heuristicMs
+           << ", \"expansion_ms\": " << max(0.0, searchMs - heuristicMs) << "}";
+        return ss.str();
+    }
+};
+
+/* Live counters of one search. Only the searching thread writes them, with a
+ * relaxed load and store that costs no more than a plain add, so any other
+ * thread may read them while the search runs. */
+class SearchCounters {
+public:
+    // one heuristic evaluation in SAMPLE_PERIOD is timed
+    static const int SAMPLE_PERIOD = 16;
+
+    void countExpansion() {
+        add(numExpansions, 1);
+    }
+
+    void countPrune() {
+        add(numPrunes, 1);
+    }
+
+    void countHeuristicEval() {
+        add(numHeuristicEvals, 1);
+    }
+
+    void countDuplicate() {
+        add(numDuplicates, 1);
+    }
+
+    void raisePeakFrontier(long long size) {
+        raise(peakFrontier, size);
+    }
+
+    void raisePeakExplored(long long size) {
+        raise(peakExplored, size);
+    }
+
+    bool takeSample() {
+        return (++sampleTick & (SAMPLE_PERIOD - 1)) == 0;
+    }
+
+    void addHeuristicTime(long long nanos) {
+        add(heuristicNanos, nanos * SAMPLE_PERIOD);
+    }
+
+    void startSearch() {
+        activeSince.store(getNanos(), memory_order_relaxed);
+    }
+
+    void stopSearch() {
+        add(searchNanos, getNanos() - activeSince.load(memory_order_relaxed));
+        activeSince.store(0, memory_order_relaxed);
+    }
+
+    SearchStats getStats() const {
+        SearchStats stats;
+        stats.numExpansions = numExpansions.load(memory_order_relaxed);
+        stats.numPrunes = numPrunes.load(memory_order_relaxed);
+        stats.numHeuristicEvals = numHeuristicEvals.load(memory_order_relaxed);
+        stats.numDuplicates = numDuplicates.load(memory_order_relaxed);
+        stats.peakFrontier = peakFrontier.load(memory_order_relaxed);
+        stats.peakExplored = peakExplored.load(memory_order_relaxed);
+        long long nanos = searchNanos.load(memory_order_relaxed);
+        long long since = activeSince.load(memory_order_relaxed);
+        if(since != 0) {
+            nanos += getNanos() - since;
+        }
+        stats.searchMs = nanos / 1e6;
+        stats.heuristicMs = min(nanos, heuristicNanos.load(memory_order_relaxed)) / 1e6;
+        return stats;
+    }
+
+    static long long getNanos() {
+        return chrono::duration_cast<chrono::nanoseconds>(
+            chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+private:
+    atomic<long long> numExpansions{0};
+    atomic<long long> numPrunes{0};
+    atomic<long long> numHeuristicEvals{0};
+    atomic<long long> numDuplicates{0};
+    atomic<long long> peakFrontier{0};
+    atomic<long long> peakExplored{0};
+    atomic<long long> heuristicNanos{0};
+    atomic<long long> searchNanos{0};
+    atomic<long long> activeSince{0}; // start of the running search, 0 if none
+    unsigned sampleTick = 0;
+
+    static void add(atomic<long long> &counter, long long amount) {
+        counter.store(counter.load(memory_order_relaxed) + amount, memory_order_relaxed);
+    }
+
+    static void raise(atomic<long long> &counter, long long value) {
+        if(value > counter.load(memory_order_relaxed)) {
+            counter.store(value, memory_order_relaxed);
+        }
+    }
+};
+
+/* Counts the time of a search while in scope. */
+class SearchTimer {
+public:
+    SearchTimer(SearchCounters &counters) : counters(counters) {
+        counters.startSearch();
+    }
+
+    ~SearchTimer() {
+        counters.stopSearch();
+    }
+
+private:
+    SearchCounters &counters;
+};
+
+/* Times the heuristic evaluations in scope, one scope in SAMPLE_PERIOD. */
+class HeuristicTimer {
+public:
+    HeuristicTimer(SearchCounters &counters) : counters(counters), start(0) {
+        if(counters.takeSample()) {
+            start = SearchCounters::getNanos();
+        }
+    }
+
+    ~HeuristicTimer() {
+        if(start != 0) {
+            counters.addHeuristicTime(SearchCounters::getNanos() - start);
+        }
+    }
+
+private:
+    SearchCounters &counters;
+    long long start;
+};
+
+/* Prints the stats of a running search to stderr as a JSON line every
+ * interval seconds, from a thread of its own, until destroyed. */
+class StatsSampler {
+public:
+    StatsSampler(double interval, function<SearchStats()> getStats, string label = "") : done(false) {
+        if(interval <= 0) {
+            return;
+        }
+        sampler = thread([this, interval, getStats, label]() {
+            auto start = chrono::steady_clock::now();
+            unique_lock<mutex> lock(doneLock);
+            while(!doneChanged.wait_for(lock, chrono::duration<double>(interval), [this]() { return done; })) {
+                chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+                stringstream ss;
+                ss << "{\"elapsed_s\": " << fixed << setprecision(3) << elapsed.count()
+                   << ", \"stats\": " << getStats().toJson() << "}";
+                writeError(ss.str(), label);
+            }
+        });
+    }
+
+    ~StatsSampler() {
+        if(sampler.joinable()) {
+            {
+                lock_guard<mutex> guard(doneLock);
+                done = true;
+            }
+            doneChanged.notify_all();
+            sampler.join();
+        }
+    }
+
+private:
+    thread sampler;
+    mutex doneLock;
+    condition_variable doneChanged;
+    bool done;
+};
+
+class Problem {
+public:
+    virtual vector<Action> actions(const State &state) = 0;
+    virtual State step(const State &state, Action action) = 0;
+    virtual int solve() = 0;
+    virtual int getNumPackagesCollected(const State &state) = 0;
+    virtual int getNumEligiblePackages(const State &state) = 0;
+    virtual string getStateString(const State &state) = 0;
+    virtual const int getN() = 0;
+    virtual const int getD() = 0;
+    virtual const int getXY(Coord coord) = 0;
+    virtual const PackageGrid& getPackageGrid() = 0;
+    virtual const vector<Symmetry>& getSymmetries() = 0;
+};
+
+/* Base of the solvers. They are templates over the problem type P, so
+ * that calls on a final problem class, such as DroneProblem, are bound at
+ * compile time and inlined; P = Problem keeps them open to any other
+ * implementation of the interface. */
+template<typename P>
+class Solver {
+public:
+    Solver(P *problem) : problem(problem) {}
+
+    virtual int solve() = 0;
+
+protected:
+    P* problem;
+};
+
+/* Depth-first branch and bound over rows, for boards of width at most W. */
+template<typename P, int W>
+class DfsSolver : public Solver<P> {
+public:
+    using Solver<P>::problem;
+
+    /* sharedOptSoFar lets several solvers prune against one incumbent, and
+     * beamWidth sets the width of the beam search that seeds it. With a
+     * budget, the search gives up once it is spent and answers with the
+     * incumbent. */
+    DfsSolver(P* problem, atomic<int>* sharedOptSoFar = nullptr, int beamWidth = 16,
+                SearchBudget* budget = nullptr)
+                : Solver<P>(problem), beamWidth(beamWidth), budget(budget), numPlaced(0),
+                numPackagesCollected(0), localOptSoFar(0), remainingBound(0) {
+        untilCheck = (budget != nullptr) ? budget->getCheckInterval() : 0;
+        n = problem -> getN();
+        d = problem -> getD();
+        packages = problem -> getPackageGrid();
+        coverageHistory.push_back(Coverage<W>());
+        boardMask.setPrefix(n);
+        boundHistory.push_back(EligibleBound(packages));
+        assignmentBound = AssignmentBound(packages);
+        matchings = vector< vector<Coord> >(d + 1);
+        moves = vector< vector<Action> >(d + 1);
+        optSoFar = (sharedOptSoFar != nullptr) ? sharedOptSoFar : &localOptSoFar;
+        colMinHistory.push_back(n);
+        colMaxHistory.push_back(-1);
+        setSymmetryBreaking(problem->getSymmetries());
+
+        // packages on the column and diagonals through each cell, which
+        // placing a drone there gives up
+        vector<int> colTotals(n, 0);
+        vector<int> diag1Totals(2 * n - 1, 0);
+        vector<int> diag2Totals(2 * n - 1, 0);
+        for(int i = 0; i < n; i++) {
+            for(int j = 0; j < n; j++) {
+                colTotals[j] += packages.get(i, j);
+                diag1Totals[i - j + n - 1] += packages.get(i, j);
+                diag2Totals[i + j] += packages.get(i, j);
+            }
+        }
+        coverCosts = vector<int>(n * n);
+        for(int i = 0; i < n; i++) {
+            for(int j = 0; j < n; j++) {
+                coverCosts[i * n + j] = colTotals[j] + diag1Totals[i - j + n - 1]
+                    + diag2Totals[i + j] - 3 * packages.get(i, j);
+            }
+        }
+    }
+    
+    int solve() {
+        SearchTimer timer(counters);
+        seedIncumbent();
+        updateOptSoFar(search());
+        return optSoFar->load();
+    }
+
+    /* Seed the incumbent with the best full placement found by a beam search
+     * that keeps the beamWidth placements with the most packages at each
+     * depth. */
+    void seedIncumbent() {
+        if(beamWidth <= 0) {
+            return;
+        }
+        vector<BeamEntry> beam(1, {0, -1, Coverage<W>()});
+        vector<BeamEntry> children;
+        for(int depth = 0; depth < d && !beam.empty(); depth++) {
+            int endRow = n - (d - depth);
+            vector<BeamMove> candidates;
+            for(int b = 0; b < (int) beam.size(); b++) {
+                for(int i = beam[b].lastRow + 1; i <= endRow; i++) {
+                    Bits<W> cols = beam[b].coverage.uncoveredInRow(i, boardMask);
+                    for(int j = cols.findNext(0); j < n; j = cols.findNext(j + 1)) {
+                        candidates.push_back({beam[b].g + packages.get(i, j), coverCosts[i * n + j], b, i, j});
+                    }
+                }
+            }
+            if((int) candidates.size() > beamWidth) {
+                nth_element(candidates.begin(), candidates.begin() + beamWidth, candidates.end());
+                candidates.resize(beamWidth);
+            }
+            children.clear();
+            for(const BeamMove &move : candidates) {
+                BeamEntry child = {move.g, move.i, beam[move.parent].coverage};
+                child.coverage.place(move.i, move.j);
+                children.push_back(child);
+            }
+            beam.swap(children);
+        }
+        for(const BeamEntry &entry : beam) {
+            updateOptSoFar(entry.g);
+        }
+    }
+
+    /* Solve the subtree below a prefix of placements and return its optimum. */
+    int solveFrom(const vector<Action> &prefix) {
+        SearchTimer timer(counters);
+        for(Action action : prefix) {
+            step(action);
+        }
+        int opt = search();
+        updateOptSoFar(opt);
+        for(int k = prefix.size() - 1; k >= 0; k--) {
+            unstep(prefix[k]);
+        }
+        return opt;
+    }
+
+    /* Collect every placement of the first depth drones, in search order. */
+    void enumeratePrefixes(int depth, vector< vector<Action> > &prefixes) {
+        if(numPlaced == depth) {
+            prefixes.push_back(history);
+            return;
+        }
+        int startingRow = (history.empty()) ? 0 : (history[history.size() - 1].first + 1);
+        int endRow = n - (d - numPlaced);
+        for(int i = startingRow; i <= endRow; i++) {
+            Bits<W> candidates = coverageHistory.back().uncoveredInRow(i, boardMask);
+            for(int j = candidates.findNext(0); j < n; j = candidates.findNext(j + 1)) {
+                step(make_pair(i,j));
+                enumeratePrefixes(depth, prefixes);
+                unstep(make_pair(i,j));
+            }
+        }
+    }
+
+    /* The peak frontier counts moves generated but not yet searched. */
+    SearchStats getStats() const {
+        return counters.getStats();
+    }
+
+    /* Best f of the subtrees left unexplored when the budget ran out, 0 when
+     * the search completed. */
+    int getRemainingBound() {
+        return remainingBound;
+    }
+
+    /* Proven upper bound on the answer; the answer itself unless the budget
+     * ran out. */
+    int getUpperBound() {
+        return max(optSoFar->load(), remainingBound);
+    }
+
+private:
+    struct BeamEntry {
+        int g;
+        int lastRow;
+        Coverage<W> coverage;
+    };
+
+    struct BeamMove {
+        int g;
+        int coverCost;
+        int parent;
+        int i;
+        int j;
+
+        bool operator<(const BeamMove &other) const {
+            if(g != other.g) {
+                return g > other.g;
+            }
+            return coverCost < other.coverCost;
+        }
+    };
+
+    PackageGrid packages;
+    vector<int> coverCosts; // packages given up by placing a drone on each cell
+    int beamWidth;
+    SearchBudget* budget;
+    int untilCheck; // expansions before the budget is checked again
+    vector< vector<Action> > moves; // move list of each depth
+    // symmetry-breaking constraints in force, see setSymmetryBreaking
+    bool breakMirrorCols;
+    bool breakRowSpan;
+    bool breakTranspose;
+    bool breakAntiTranspose;
+    vector<int> colMinHistory;
+    vector<int> colMaxHistory;
+    vector< Coverage<W> > coverageHistory;
+    vector< EligibleBound > boundHistory;
+    AssignmentBound assignmentBound;
+    vector< vector<Coord> > matchings; // assignment found at each depth
+    Bits<W> boardMask;
+    vector< Action > history;
+    int n;
+    int d;
+    int numPlaced;
+    int numPackagesCollected;
+    SearchCounters counters;
+    atomic<int> localOptSoFar;
+    atomic<int>* optSoFar;
+    int remainingBound;
+    long long numOpen = 0; // moves generated but not yet searched
+
+    int search() {
+        counters.countExpansion();
+
+        if(breaksSymmetry()) {
+            return 0;
+        }
+
+        if(numPlaced == d) {
+            return numPackagesCollected;
+        }
+
+        if(isOutOfBudget()) {
+            // leave the subtree unexplored, but remember what it could hold
+            remainingBound = max(remainingBound, numPackagesCollected + getOverestimation());
+            return 0;
+        }
+
+        int opt = 0;
+
+        int startingRow = (history.empty()) ? 0 : (history[history.size() - 1].first + 1);
+        int upperBound = getUpperBound(startingRow);
+        if(upperBound <= optSoFar->load(memory_order_relaxed)) {
+            counters.countPrune();
+            return 0;
+        }
+
+        const vector<Action> &candidates = orderMoves(startingRow);
+        numOpen += candidates.size();
+        counters.raisePeakFrontier(numOpen);
+        for(int k = 0; k < (int) candidates.size(); k++) {
+            Action action = candidates[k];
+            numOpen--;
+            // stepping
+            step(action);
+            opt = max(opt, search());
+            unstep(action);
+            updateOptSoFar(opt);
+            if(opt == upperBound) {
+                numOpen -= candidates.size() - k - 1;
+                return opt;
+            }
+        }
+
+        return opt;
+    }
+
+    /* Bound on the best placement below the current node: the eligible
+     * bound, tightened by the assignment bound unless it already prunes. */
+    int getUpperBound(int startingRow) {
+        HeuristicTimer timer(counters);
+        counters.countHeuristicEval();
+        int upperBound = numPackagesCollected + getOverestimation();
+        if(upperBound <= optSoFar->load(memory_order_relaxed)) {
+            return upperBound;
+        }
+        counters.countHeuristicEval();
+        return numPackagesCollected + getAssignmentBound(startingRow, upperBound - numPackagesCollected);
+    }
+
+    /* Moves of the current node, row by row. Within a row, cells with more
+     * packages come first and ties go to the cell giving up fewer packages
+     * on its column and diagonals. */
+    const vector<Action>& orderMoves(int startingRow) {
+        vector<Action> &res = moves[numPlaced];
+        res.clear();
+        int endRow = n - (d - numPlaced);
+        auto better = [this](Action a1, Action a2) {
+            int v1 = packages.get(a1.first, a1.second);
+            int v2 = packages.get(a2.first, a2.second);
+            if(v1 != v2) {
+                return v1 > v2;
+            }
+            return coverCosts[a1.first * n + a1.second] < coverCosts[a2.first * n + a2.second];
+        };
+        for(int i = startingRow; i <= endRow; i++) {
+            int rowBegin = res.size();
+            Bits<W> candidates = coverageHistory.back().uncoveredInRow(i, boardMask);
+            for(int j = candidates.findNext(0); j < n; j = candidates.findNext(j + 1)) {
+                res.push_back(make_pair(i,j));
+            }
+            sort(res.begin() + rowBegin, res.end(), better);
+        }
+        return res;
+    }
+
+    void updateOptSoFar(int opt) {
+        int current = optSoFar->load(memory_order_relaxed);
+        while(opt > current
+            && !optSoFar->compare_exchange_weak(current, opt, memory_order_relaxed));
+    }
+
+    bool isOutOfBudget() {
+        if(budget == nullptr) {
+            return false;
+        }
+        if(--untilCheck == 0) {
+            budget->check(optSoFar->load(memory_order_relaxed));
+            untilCheck = budget->getCheckInterval();
+        }
+        return budget->isStopped();
+    }
+
+    void step(Action action) {
+        // create new coverage
+        Coverage<W> coverage = coverageHistory.back();
+        coverage.place(action.first, action.second);
+        coverageHistory.push_back(coverage);
+
+        // update the bound incrementally
+        boundHistory.push_back(boundHistory.back());
+        boundHistory.back().place(action.first, action.second);
+        
+        // update history
+        history.push_back(action);
+        colMinHistory.push_back(min(colMinHistory.back(), action.second));
+        colMaxHistory.push_back(max(colMaxHistory.back(), action.second));
+
+        // update numPlaced
+        numPlaced++;
+
+        // update numPackagesCollected
+        numPackagesCollected += packages.get(action.first, action.second);
+    }
+
+    void unstep(Action action) {
+        coverageHistory.pop_back();
+        boundHistory.pop_back();
+
+        history.pop_back();
+        colMinHistory.pop_back();
+        colMaxHistory.pop_back();
+
+        numPlaced--;
+
+        numPackagesCollected -= packages.get(action.first, action.second);
+    }
+
+    /* Every placement has an image under each symmetry of the layout that
+     * collects as many packages, so the search only needs one placement of
+     * each orbit. A constraint is kept for each symmetry that any orbit can
+     * satisfy, comparing a placement with its image:
+     * - mirrored columns: the first drone is in the left half,
+     * - mirrored rows or half turn: first row + last row <= n - 1,
+     * - transpose: first row <= smallest column,
+     * - anti-transpose: first row + largest column <= n - 1.
+     * Row constraints survive a column mirror, so the first two combine; the
+     * diagonal ones are only used when they are the whole group. */
+    void setSymmetryBreaking(const vector<Symmetry> &symmetries) {
+        bool has[NUM_SYMMETRIES] = {false};
+        for(Symmetry symmetry : symmetries) {
+            has[symmetry] = true;
+        }
+        breakMirrorCols = has[MIRROR_COLS];
+        breakRowSpan = has[MIRROR_ROWS] || has[ROTATE_180];
+        bool rowPreserving = breakMirrorCols || breakRowSpan;
+        breakTranspose = !rowPreserving && has[TRANSPOSE];
+        breakAntiTranspose = !rowPreserving && !breakTranspose && has[ANTI_TRANSPOSE];
+    }
+
+    /* Whether every completion of the current placement breaks a symmetry
+     * constraint. Rows only grow, the smallest column only shrinks and the
+     * largest only grows, so a violation is final. */
+    bool breaksSymmetry() {
+        if(numPlaced == 0) {
+            return false;
+        }
+        int firstRow = history[0].first;
+        if(breakMirrorCols && history[0].second > n - 1 - history[0].second) {
+            return true;
+        }
+        if(breakRowSpan && firstRow + history.back().first > n - 1) {
+            return true;
+        }
+        if(breakTranspose && colMinHistory.back() < firstRow) {
+            return true;
+        }
+        if(breakAntiTranspose && firstRow + colMaxHistory.back() > n - 1) {
+            return true;
+        }
+        return false;
+    }
+
+    int getOverestimation() { // O(n)
+        return boundHistory.back().getBound(d - numPlaced);
+    }
+
+    /* Tighten cap with the assignment bound, unless what is left of the
+     * parent's assignment already shows the node cannot be pruned. */
+    int getAssignmentBound(int firstRow, int cap) {
+        const Coverage<W> &coverage = coverageHistory.back();
+        auto covered = [&coverage](int i, int j) {
+            return coverage.covered(i, j);
+        };
+        int target = optSoFar->load(memory_order_relaxed) - numPackagesCollected;
+        int numDronesLeft = d - numPlaced;
+        if(numPlaced > 0) {
+            int inherited = assignmentBound.getMatchingWeight(matchings[numPlaced - 1], covered,
+                firstRow, numDronesLeft, matchings[numPlaced], packages);
+            if(inherited > target) {
+                return cap;
+            }
+        }
+        int res = assignmentBound.getBound(covered, firstRow, numDronesLeft, cap, target);
+        matchings[numPlaced] = assignmentBound.getMatching();
+        return res;
+    }
+};
+
+/* Branch and bound that splits the tree into subtrees below the first one or
+ * two placements and solves them on a work-stealing pool, all pruning against
+ * a shared incumbent. */
+template<typename P, int W>
+class ParallelDfsSolver : public Solver<P> {
+public:
+    using Solver<P>::problem;
+
+    ParallelDfsSolver(P* problem, int numThreads, int beamWidth = 16,
+                SearchBudget* budget = nullptr) : Solver<P>(problem),
+                numThreads(numThreads), beamWidth(beamWidth), budget(budget), optSoFar(0),
+                remainingBound(0) {
+        if(this->numThreads <= 0) {
+            this->numThreads = max(1u, thread::hardware_concurrency());
+        }
+        for(int t = 0; t < this->numThreads; t++) {
+            workers.push_back(unique_ptr< DfsSolver<P, W> >(new DfsSolver<P, W>(problem, &optSoFar, beamWidth, budget)));
+        }
+    }
+
+    int solve() {
+        int d = problem->getD();
+        if(d == 0) {
+            return 0;
+        }
+
+        // split on the first row, or the first two when that leaves too few subtrees
+        vector< vector<Action> > prefixes;
+        DfsSolver<P, W>(problem).enumeratePrefixes(1, prefixes);
+        if(d >= 2 && (int) prefixes.size() < 8 * numThreads) {
+            prefixes.clear();
+            DfsSolver<P, W>(problem).enumeratePrefixes(2, prefixes);
+        }
+
+        // most valuable subtrees first
+        const PackageGrid &packages = problem->getPackageGrid();
+        auto getValue = [&packages](const vector<Action> &prefix) {
+            int res = 0;
+            for(Action action : prefix) {
+                res += packages.get(action.first, action.second);
+            }
+            return res;
+        };
+        stable_sort(prefixes.begin(), prefixes.end(), [&getValue](const vector<Action> &p1, const vector<Action> &p2) {
+            return getValue(p1) > getValue(p2);
+        });
+
+        workers[0]->seedIncumbent();
+
+        // deal contiguous blocks so each worker starts in a different part of the tree
+        WorkStealingPool pool(numThreads);
+        for(int k = 0; k < (int) prefixes.size(); k++) {
+            vector<Action> prefix = prefixes[k];
+            pool.submit([this, prefix](int worker) {
+                workers[worker]->solveFrom(prefix);
+            }, (long long) k * numThreads / prefixes.size());
+        }
+        pool.run();
+
+        for(int t = 0; t < numThreads; t++) {
+            remainingBound = max(remainingBound, workers[t]->getRemainingBound());
+        }
+        return optSoFar.load();
+    }
+
+    /* Proven upper bound on the answer; the answer itself unless the budget
+     * ran out. */
+    int getUpperBound() {
+        return max(optSoFar.load(), remainingBound);
+    }
+
+    vector<long long> getThreadExpansions() {
+        vector<long long> threadExpansions;
+        for(const unique_ptr< DfsSolver<P, W> > &worker : workers) {
+            threadExpansions.push_back(worker->getStats().numExpansions);
+        }
+        return threadExpansions;
+    }
+
+    /* Totals over the workers; safe to call while they search. */
+    SearchStats getStats() const {
+        SearchStats stats;
+        for(const unique_ptr< DfsSolver<P, W> > &worker : workers) {
+            stats.merge(worker->getStats());
+        }
+        return stats;
+    }
+
+private:
+    int numThreads;
+    int beamWidth;
+    SearchBudget* budget;
+    atomic<int> optSoFar;
+    int remainingBound;
+    vector< unique_ptr< DfsSolver<P, W> > > workers;
+};
+
+/* Chunked bump allocator handing out nodes by index. Chunks never move, and
+ * nodes are not freed one by one: they all go with the arena. */
+template<typename T>
+class NodeArena {
+public:
+    NodeArena() : numNodes(0) {}
+
+    int allocate() {
+        if((numNodes & (CHUNK_SIZE - 1)) == 0) {
+            chunks.push_back(unique_ptr<T[]>(new T[CHUNK_SIZE]));
+        }
+        return numNodes++;
+    }
+
+    T& operator[](int index) {
+        return chunks[index >> CHUNK_BITS][index & (CHUNK_SIZE - 1)];
+    }
+
+    int size() const {
+        return numNodes;
+    }
+
+    long long getMemoryUsage() const {
+        return (long long) chunks.size() * CHUNK_SIZE * sizeof(T);
+    }
+
+private:
+    static const int CHUNK_BITS = 16;
+    static const int CHUNK_SIZE = 1 << CHUNK_BITS;
+
+    vector< unique_ptr<T[]> > chunks;
+    int numNodes;
+};
+
+/* A* node as kept in the arena: its placements are found by following the
+ * parent links. */
+struct SearchNode {
+    Action action; // last drone placed
+    int parent; // index of the parent node, -1 for the root
+    int depth; // number of drones placed
+};
+
+/* Frontier record of the A* search. f, g and h are computed once when the
+ * node is generated, so the bucket queue files it by integers alone. */
+struct AstarNode {
+    int f; // g + h
+    int g; // packages collected so far
+    int h; // estimate of packages still collectable
+    int index; // index of the node in the arena
+    uint64_t key; // Zobrist key of the node's state
+    bool refined; // h already tightened by the assignment bound
+};
+
+/* A* frontier. Nodes go in buckets, one stack for each (f, g) pair that has
+ * nodes, kept in an ordered map. top() is the last node pushed with the
+ * largest f, and among those the largest g. f and g reach the number of
+ * packages, so only the pairs in use get a bucket: memory grows with the
+ * nodes, not with the range of f and g. */
+class BucketQueue {
+public:
+    BucketQueue() : numNodes(0), capacity(0) {}
+
+    bool empty() const {
+        return numNodes == 0;
+    }
+
+    long long size() const {
+        return numNodes;
+    }
+
+    const AstarNode& top() const {
+        return buckets.rbegin()->second.back();
+    }
+
+    void push(const AstarNode &node) {
+        vector<AstarNode> &bucket = buckets[make_pair(node.f, node.g)];
+        capacity -= bucket.capacity();
+        bucket.push_back(node);
+        capacity += bucket.capacity();
+        numNodes++;
+    }
+
+    void pop() {
+        auto last = prev(buckets.end());
+        last->second.pop_back();
+        numNodes--;
+        if(last->second.empty()) {
+            capacity -= last->second.capacity();
+            buckets.erase(last);
+        }
+    }
+
+    /* Number of nodes of every non-empty f, largest f first. */
+    vector< pair<int, long long> > getOccupancy() const {
+        vector< pair<int, long long> > occupancy;
+        for(auto bucket = buckets.rbegin(); bucket != buckets.rend(); bucket++) {
+            int f = bucket->first.first;
+            if(occupancy.empty() || occupancy.back().first != f) {
+                occupancy.push_back(make_pair(f, 0LL));
+            }
+            occupancy.back().second += bucket->second.size();
+        }
+        return occupancy;
+    }
+
+    /* Bytes of the nodes' stacks and of the map's entries, about four
+     * pointers each besides the key and the stack. */
+    long long getMemoryUsage() const {
+        long long entrySize = sizeof(pair<int, int>) + sizeof(vector<AstarNode>) + 4 * sizeof(void*);
+        return capacity * (long long) sizeof(AstarNode) + (long long) buckets.size() * entrySize;
+    }
+
+private:
+    map< pair<int, int>, vector<AstarNode> > buckets; // by (f, g)
+    long long numNodes;
+    long long capacity; // nodes the stacks have room for
+};
+
+template<typename P>
+class AstarSolver : public Solver<P> {
+public:
+    using Solver<P>::problem;
+
+    /* memoryBudget is in bytes; a negative budget means unlimited. With
+     * reportOccupancy, the frontier's buckets are printed to stderr whenever
+     * the number of expansions reaches a power of two. sharedCounters lets
+     * another solver collect A*'s counters with its own. */
+    AstarSolver(P* problem, long long memoryBudget = -1, bool reportOccupancy = false,
+                SearchCounters* sharedCounters = nullptr)
+                : Solver<P>(problem), memoryBudget(memoryBudget), reportOccupancy(reportOccupancy),
+                outOfMemory(false), upperBound(0) {
+        counters = (sharedCounters != nullptr) ? sharedCounters : &localCounters;
+        rootBound = EligibleBound(problem->getPackageGrid());
+        assignmentBound = AssignmentBound(problem->getPackageGrid());
+        zobrist = ZobristKeys(problem->getN());
+        // mirroring the columns keeps every row, so a state and its mirror
+        // image have mirrored successors and only one needs to be searched
+        const vector<Symmetry> &symmetries = problem->getSymmetries();
+        mirrorSymmetric = find(symmetries.begin(), symmetries.end(), MIRROR_COLS) != symmetries.end();
+    }
+
+    int solve() {
+        SearchTimer timer(*counters);
+        NodeArena<SearchNode> arena; // every node generated, freed with the arena
+        BucketQueue frontier;
+        TranspositionTable seen; // every state ever generated, explored or not
+        // kept alongside the counters, which are costly to read back
+        long long numExpansions = counters->getStats().numExpansions;
+        int root = arena.allocate();
+        arena[root] = {make_pair(-1, -1), -1, 0};
+        frontier.push(makeNode(0, rootBound.getBound(problem->getD()), root, 0));
+        seen.insert(0);
+        while(true) {
+            if(frontier.empty()) {
+                // failure
+                return 0;
+            }
+            AstarNode node = frontier.top();
+            frontier.pop();
+            const SearchNode searchNode = arena[node.index];
+
+            if(problem->getD() == searchNode.depth) {
+                upperBound = node.g;
+                return node.g;
+            }
+
+            // tighten h with the assignment bound when the node first comes
+            // up, and put it back if that lowers its f
+            uint64_t mirrorKey;
+            EligibleBound bound = getBound(arena, node.index, mirrorKey);
+            int firstRow = searchNode.action.first + 1;
+            if(!node.refined) {
+                auto covered = [&bound](int i, int j) {
+                    return bound.covered(i, j);
+                };
+                int h;
+                {
+                    HeuristicTimer heuristicTimer(*counters);
+                    counters->countHeuristicEval();
+                    h = assignmentBound.getBound(covered, firstRow, problem->getD() - searchNode.depth, node.h);
+                }
+                if(h < node.h) {
+                    AstarNode refinedNode = makeNode(node.g, h, node.index, node.key);
+                    refinedNode.refined = true;
+                    frontier.push(refinedNode);
+                    continue;
+                }
+            }
+
+            // give up once the stored nodes outgrow the budget, keeping the
+            // best f left in the frontier as a proven bound on the answer
+            if(memoryBudget >= 0 && seen.getMemoryUsage() + arena.getMemoryUsage()
+                    + frontier.getMemoryUsage() > memoryBudget) {
+                outOfMemory = true;
+                upperBound = node.f;
+                return 0;
+            }
+            counters->countExpansion();
+            numExpansions++;
+            if(reportOccupancy && (numExpansions & (numExpansions - 1)) == 0) {
+                printOccupancy(frontier, numExpansions);
+            }
+
+            int n = problem->getN();
+            int numDronesLeft = problem->getD() - searchNode.depth - 1;
+            int endRow = n - numDronesLeft - 1;
+            for(int i = firstRow; i <= endRow; i++) {
+                for(int j = 0; j < n; j++) {
+                    if(bound.covered(i, j)) {
+                        continue;
+                    }
+                    Action action = make_pair(i, j);
+                    uint64_t nextKey = zobrist.step(node.key, action);
+                    uint64_t canonicalKey = nextKey;
+                    if(mirrorSymmetric) {
+                        canonicalKey = min(nextKey, zobrist.step(mirrorKey, mirror(action)));
+                    }
+                    if(!seen.insert(canonicalKey)) {
+                        counters->countDuplicate();
+                    }
+                    else {
+                        int g = node.g + problem->getXY(action);
+                        int h;
+                        {
+                            HeuristicTimer heuristicTimer(*counters);
+                            counters->countHeuristicEval();
+                            EligibleBound nextBound = bound;
+                            nextBound.place(i, j);
+                            h = nextBound.getBound(numDronesLeft);
+                        }
+                        int child = arena.allocate();
+                        arena[child] = {action, node.index, searchNode.depth + 1};
+                        frontier.push(makeNode(g, h, child, nextKey));
+                    }
+                }
+            }
+            counters->raisePeakFrontier(frontier.size());
+            counters->raisePeakExplored(seen.size());
+        }
+    }
+
+    bool isOutOfMemory() {
+        return outOfMemory;
+    }
+
+    /* The peak explored size counts every state ever generated. */
+    SearchStats getStats() const {
+        return counters->getStats();
+    }
+
+    /* Upper bound on the answer: the answer itself, or the best f left in
+     * the frontier when the search ran out of memory. */
+    int getUpperBound() {
+        return upperBound;
+    }
+
+private:
+    EligibleBound rootBound;
+    AssignmentBound assignmentBound;
+    ZobristKeys zobrist;
+    bool mirrorSymmetric; // the layout is symmetric under MIRROR_COLS
+    long long memoryBudget;
+    bool reportOccupancy;
+    bool outOfMemory;
+    int upperBound;
+    SearchCounters localCounters;
+    SearchCounters* counters;
+
+    /* One line with the size of the frontier and its f buckets. */
+    void printOccupancy(const BucketQueue &frontier, long long numExpansions) {
+        stringstream ss;
+        ss << "frontier after " << numExpansions << " expansions: " << frontier.size() << " nodes,";
+        for(pair<int, long long> bucket : frontier.getOccupancy()) {
+            ss << " f=" << bucket.first << ":" << bucket.second;
+        }
+        writeError(ss.str(), problem->getLabel());
+    }
+
+    /* Bound of a node's placements, built by walking its parent links,
+     * and the Zobrist key of their mirror image. */
+    EligibleBound getBound(NodeArena<SearchNode> &arena, int index, uint64_t &mirrorKey) {
+        EligibleBound bound = rootBound;
+        mirrorKey = 0;
+        for(int k = index; arena[k].parent >= 0; k = arena[k].parent) {
+            Action action = arena[k].action;
+            bound.place(action.first, action.second);
+            mirrorKey = zobrist.step(mirrorKey, mirror(action));
+        }
+        return bound;
+    }
+
+    Action mirror(Action action) {
+        return transform(MIRROR_COLS, action, problem->getN());
+    }
+
+    AstarNode makeNode(int g, int h, int index, uint64_t key) {
+        return {g + h, g, h, index, key, false};
+    }
+};
+
+/* Memory-bounded search. Runs A* until its nodes outgrow the memory budget,
+ * then falls back to iterative-deepening A*, which only keeps the current
+ * path. IDA* starts from the bound A* had proven (or from the root heuristic
+ * when the budget is zero) and lowers the threshold to the best f it pruned
+ * until a placement reaches it. */
+template<typename P>
+class IdaStarSolver : public Solver<P> {
+public:
+    using Solver<P>::problem;
+
+    /* memoryBudget is in bytes; reportOccupancy is passed on to A*. */
+    IdaStarSolver(P* problem, long long memoryBudget, bool reportOccupancy = false)
+                : Solver<P>(problem), memoryBudget(memoryBudget), reportOccupancy(reportOccupancy) {
+        n = problem->getN();
+        d = problem->getD();
+        packages = problem->getPackageGrid();
+    }
+
+    int solve() {
+        EligibleBound rootBound(packages);
+        threshold = rootBound.getBound(d);
+        if(memoryBudget > 0) {
+            AstarSolver<P> astar(problem, memoryBudget, reportOccupancy, &counters);
+            int res = astar.solve();
+            if(!astar.isOutOfMemory()) {
+                threshold = res;
+                return res;
+            }
+            threshold = astar.getUpperBound();
+        }
+
+        SearchTimer timer(counters);
+        while(true) {
+            nextThreshold = -1;
+            int res = search(rootBound, 0, 0, -1);
+            if(res >= threshold) {
+                threshold = res;
+                return res;
+            }
+            if(nextThreshold < 0) {
+                // no placement of all drones
+                threshold = 0;
+                return 0;
+            }
+            threshold = nextThreshold;
+        }
+    }
+
+    /* Counters of both phases. The peak frontier and explored sizes are
+     * those of A*, as IDA* only keeps the path. */
+    SearchStats getStats() const {
+        return counters.getStats();
+    }
+
+    /* The answer, which IDA* always proves. */
+    int getUpperBound() {
+        return threshold;
+    }
+
+private:
+    PackageGrid packages;
+    long long memoryBudget;
+    bool reportOccupancy;
+    int n;
+    int d;
+    int threshold; // no placement collects more than this
+    int nextThreshold; // best f pruned in this iteration
+    SearchCounters counters;
+
+    /* Best placement below the node with f >= threshold, or -1 if none. */
+    int search(EligibleBound &bound, int numPlaced, int g, int lastRow) {
+        counters.countExpansion();
+
+        if(numPlaced == d) {
+            return g;
+        }
+
+        int best = -1;
+        int endRow = n - (d - numPlaced);
+        for(int i = lastRow + 1; i <= endRow; i++) {
+            for(int j = 0; j < n; j++) {
+                if(bound.covered(i, j)) {
+                    continue;
+                }
+                EligibleBound nextBound = bound;
+                int nextG = g + packages.get(i, j);
+                int f;
+                {
+                    HeuristicTimer heuristicTimer(counters);
+                    counters.countHeuristicEval();
+                    nextBound.place(i, j);
+                    f = nextG + nextBound.getBound(d - numPlaced - 1);
+                }
+                if(f < threshold) {
+                    counters.countPrune();
+                    nextThreshold = max(nextThreshold, f);
+                    continue;
+                }
+                best = max(best, search(nextBound, numPlaced + 1, nextG, i));
+                if(best >= threshold) {
+                    return best;
+                }
+            }
+        }
+        return best;
+    }
+};
+
+/* What the rows from row on still see of the placements above them: the
+ * covered columns and the covered diagonals that cross those rows. Two
+ * placements with the same profile and drones left have the same best
+ * completion. */
+template<int W>
+struct RowProfile {
+    Bits<W> cols;
+    Bits<2 * W> diag1;
+    Bits<2 * W> diag2;
+    int row;
+    int numDronesLeft;
+
+    uint64_t getHash() const {
+        uint64_t h = (uint64_t(row) << 32) | uint64_t(numDronesLeft);
+        auto mix = [&h](uint64_t word) {
+            h = (h ^ word) * 0x9e3779b97f4a7c15ULL;
+            h ^= h >> 29;
+        };
+        for(int w = 0; w < Bits<W>::NUM_WORDS; w++) {
+            mix(cols.words[w]);
+        }
+        for(int w = 0; w < Bits<2 * W>::NUM_WORDS; w++) {
+            mix(diag1.words[w]);
+            mix(diag2.words[w]);
+        }
+        return h;
+    }
+
+    bool operator==(const RowProfile &other) const {
+        return row == other.row && numDronesLeft == other.numDronesLeft
+            && memcmp(cols.words, other.cols.words, sizeof(cols.words)) == 0
+            && memcmp(diag1.words, other.diag1.words, sizeof(diag1.words)) == 0
+            && memcmp(diag2.words, other.diag2.words, sizeof(diag2.words)) == 0;
+    }
+};
+
+/* Bounded cache from a row profile to the value of its subproblem, exact or
+ * an upper bound. Entries are grouped in sets of WAYS; a full set evicts by
+ * the clock rule, so an entry read since the hand last passed it gets a
+ * second chance. The cache starts small and doubles while half full, up to
+ * its memory budget. */
+template<int W>
+class ProfileCache {
+public:
+    static const int WAYS = 4;
+
+    /* memoryBudget is in bytes; the cache takes at most that much, but has
+     * at least one set. */
+    ProfileCache(long long memoryBudget) : numEntries(0) {
+        maxSets = 1;
+        while((long long) (2 * maxSets * WAYS * sizeof(Entry)) <= memoryBudget) {
+            maxSets <<= 1;
+        }
+        entries = vector<Entry>(min(maxSets, INITIAL_SETS) * WAYS);
+        hands = vector<uint8_t>(entries.size() / WAYS, 0);
+    }
+
+    bool find(const RowProfile<W> &profile, uint64_t hash, int &value, bool &exact) {
+        Entry* set = getSet(hash);
+        for(int way = 0; way < WAYS; way++) {
+            Entry &entry = set[way];
+            if(entry.used && entry.hash == hash && entry.profile == profile) {
+                entry.referenced = true;
+                value = entry.value;
+                exact = entry.exact;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void store(const RowProfile<W> &profile, uint64_t hash, int value, bool exact) {
+        if(2 * (numEntries + 1) > entries.size() && hands.size() < maxSets) {
+            grow();
+        }
+        Entry* set = getSet(hash);
+        int victim = -1;
+        for(int way = 0; way < WAYS; way++) {
+            if(!set[way].used) {
+                if(victim < 0) {
+                    victim = way;
+                }
+            }
+            else if(set[way].hash == hash && set[way].profile == profile) {
+                victim = way;
+                break;
+            }
+        }
+        if(victim < 0) {
+            uint8_t &hand = hands[(set - entries.data()) / WAYS];
+            while(set[hand].referenced) {
+                set[hand].referenced = false;
+                hand = (hand + 1) % WAYS;
+            }
+            victim = hand;
+            hand = (hand + 1) % WAYS;
+        }
+        else if(!set[victim].used) {
+            numEntries++;
+        }
+        set[victim] = {profile, hash, value, exact, false, true};
+    }
+
+    size_t size() {
+        return numEntries;
+    }
+
+private:
+    static constexpr size_t INITIAL_SETS = 1024;
+
+    struct Entry {
+        RowProfile<W> profile;
+        uint64_t hash;
+        int value;
+        bool exact; // otherwise value is only an upper bound
+        bool referenced;
+        bool used;
+    };
+
+    vector<Entry> entries;
+    vector<uint8_t> hands; // clock hand of every set
+    size_t maxSets;
+    size_t numEntries;
+
+    Entry* getSet(uint64_t hash) {
+        return entries.data() + (hash & (hands.size() - 1)) * WAYS;
+    }
+
+    void grow() {
+        vector<Entry> old(2 * entries.size());
+        old.swap(entries);
+        hands = vector<uint8_t>(entries.size() / WAYS, 0);
+        numEntries = 0;
+        for(const Entry &entry : old) {
+            if(entry.used) {
+                store(entry.profile, entry.hash, entry.value, entry.exact);
+            }
+        }
+    }
+};
+
+/* Memoized search over rows for boards of width at most W. At each row it
+ * either places a drone on an uncovered cell of the row or skips the row,
+ * and the best completion below a row depends only on the row profile, so
+ * it is cached and reused by every placement reaching the same profile.
+ * Subtrees are pruned with the eligible bound against what they must beat,
+ * and a pruned subtree is cached as an upper bound, which is reused while
+ * the subtree still cannot matter. */
+template<typename P, int W>
+class MemoSolver : public Solver<P> {
+public:
+    using Solver<P>::problem;
+
+    /* memoryBudget is in bytes and sizes the cache; beamWidth is that of the
+     * beam search seeding the incumbent, as in DfsSolver. */
+    MemoSolver(P* problem, long long memoryBudget, int beamWidth = 16)
+                : Solver<P>(problem), beamWidth(beamWidth), cache(memoryBudget), optSoFar(0) {
+        n = problem->getN();
+        d = problem->getD();
+        packages = problem->getPackageGrid();
+        boardMask.setPrefix(n);
+        // the diagonals of rows row and below, see Coverage for their indices
+        diag1Masks = vector< Bits<2 * W> >(n + 1);
+        diag2Masks = vector< Bits<2 * W> >(n + 1);
+        for(int row = 0; row <= n; row++) {
+            diag1Masks[row].setPrefix(W + n - 1 - row);
+            diag2Masks[row].setPrefix(row);
+            diag2Masks[row] = ~diag2Masks[row];
+        }
+        // cells of each row, most packages first
+        rowOrders = vector< vector<int> >(n);
+        for(int i = 0; i < n; i++) {
+            for(int j = 0; j < n; j++) {
+                rowOrders[i].push_back(j);
+            }
+            stable_sort(rowOrders[i].begin(), rowOrders[i].end(), [this, i](int j1, int j2) {
+                return packages.get(i, j1) > packages.get(i, j2);
+            });
+        }
+    }
+
+    int solve() {
+        DfsSolver<P, W> seeder(problem, &optSoFar, beamWidth);
+        seeder.seedIncumbent();
+
+        SearchTimer timer(counters);
+        EligibleBound bound(packages);
+        Outcome res = search(0, d, Coverage<W>(), bound, optSoFar.load());
+        answer = max(optSoFar.load(), res.value);
+        return answer;
+    }
+
+    /* The peak frontier is the deepest row reached, the peak explored size
+     * the number of profiles cached and the duplicates the cache hits. */
+    SearchStats getStats() const {
+        return counters.getStats();
+    }
+
+    /* The answer, which the search always proves. */
+    int getUpperBound() {
+        return answer;
+    }
+
+private:
+    // value of a subproblem in which the drones left do not fit
+    static const int INFEASIBLE = numeric_limits<int>::min() / 4;
+
+    /* Value of a subproblem; when not exact, an upper bound on it that is no
+     * more than what the subproblem had to beat. */
+    struct Outcome {
+        int value;
+        bool exact;
+    };
+
+    PackageGrid packages;
+    int beamWidth;
+    ProfileCache<W> cache;
+    Bits<W> boardMask;
+    vector< Bits<2 * W> > diag1Masks;
+    vector< Bits<2 * W> > diag2Masks;
+    vector< vector<int> > rowOrders;
+    int n;
+    int d;
+    atomic<int> optSoFar;
+    int answer = 0;
+    SearchCounters counters;
+
+    RowProfile<W> getProfile(int row, int numDronesLeft, const Coverage<W> &coverage) {
+        RowProfile<W> profile;
+        profile.cols = coverage.cols;
+        profile.diag1 = coverage.diag1;
+        profile.diag1 &= diag1Masks[row];
+        profile.diag2 = coverage.diag2;
+        profile.diag2 &= diag2Masks[row];
+        profile.row = row;
+        profile.numDronesLeft = numDronesLeft;
+        return profile;
+    }
 
-            #ifdef DEBUG
-            cout << problem->getStateString(state) << endl;
-            #endif
+    /* Best placement of numDronesLeft drones on rows from row on, when only
+     * values above alpha matter. */
+    Outcome search(int row, int numDronesLeft, const Coverage<W> &coverage, EligibleBound &bound, int alpha) {
+        counters.countExpansion();
+        counters.raisePeakFrontier(row);
 
-            if(problem->getD() == state.size()) {
-                return problem->getNumPackagesCollected(state);
-            }
-            explored.insert(state);
-            for(Action action : problem->actions(state)) {
-                State nextState = problem->step(state, action);
+        if(numDronesLeft == 0) {
+            return {0, true};
+        }
+        if(n - row < numDronesLeft) {
+            return {INFEASIBLE, true};
+        }
 
-                if(explored.find(nextState) == explored.end()
-                    && frontierSet.find(nextState) == frontierSet.end()) {
-                    frontier.push(nextState);
-                    frontierSet.insert(nextState);
-                }
+        RowProfile<W> profile = getProfile(row, numDronesLeft, coverage);
+        uint64_t hash = profile.getHash();
+        int upperBound = numeric_limits<int>::max();
+        int cached;
+        bool exact;
+        if(cache.find(profile, hash, cached, exact)) {
+            if(exact || cached <= alpha) {
+                counters.countDuplicate();
+                return {cached, exact};
             }
+            upperBound = cached;
         }
-    }
 
-private:
-    int heuristic(State state) {
-        return problem->getNumEligiblePackages(state);
-    }
-};
+        {
+            HeuristicTimer timer(counters);
+            counters.countHeuristicEval();
+            upperBound = min(upperBound, bound.getBound(numDronesLeft));
+        }
+        if(upperBound <= alpha) {
+            counters.countPrune();
+            return {upperBound, false};
+        }
 
-class DroneProblem : public Problem {
-public:
-    DroneProblem(int n, int d, vector<Coord> coords, string algorithm)
-            : n(n), d(d), algorithm(algorithm) {
-        for(Coord coord : coords) {
-            auto it = packages.find(coord);
-            if(it == packages.end()) {
-                packages.insert(make_pair(coord, 1));
+        int best = INFEASIBLE; // best exact completion
+        int failLow = INFEASIBLE; // best upper bound of the other completions
+        auto record = [&best, &failLow](Outcome child, int gain) {
+            if(child.exact) {
+                best = max(best, gain + child.value);
             }
             else {
-                it->second++;
+                failLow = max(failLow, gain + child.value);
+            }
+        };
+        Bits<W> cols = coverage.uncoveredInRow(row, boardMask);
+        for(int j : rowOrders[row]) {
+            if(!cols.test(j)) {
+                continue;
             }
+            int gain = packages.get(row, j);
+            Coverage<W> nextCoverage = coverage;
+            nextCoverage.place(row, j);
+            EligibleBound nextBound = bound;
+            nextBound.place(row, j);
+            record(search(row + 1, numDronesLeft - 1, nextCoverage, nextBound, max(alpha, best) - gain), gain);
+            if(best >= upperBound) {
+                break;
+            }
+        }
+        if(best < upperBound && n - row > numDronesLeft) {
+            record(search(row + 1, numDronesLeft, coverage, bound, max(alpha, best)), 0);
         }
+
+        Outcome res = (failLow <= best) ? Outcome{best, true} : Outcome{failLow, false};
+        cache.store(profile, hash, res.value, res.exact);
+        counters.raisePeakExplored(cache.size());
+        return res;
+    }
+};
+
+class DroneProblem final : public Problem {
+public:
+    DroneProblem(int n, int d, PackageGrid packages, string algorithm,
+                SearchOptions options = SearchOptions())
+            : n(n), d(d), packages(packages), algorithm(algorithm), options(options) {
+        eligibleBound = EligibleBound(packages);
+        symmetries = packages.getSymmetries();
     }
 
-    vector<Action> actions(State state) {
+    /* Packages are given by their coordinates; those off the board are
+     * dropped. */
+    DroneProblem(int n, int d, vector<Coord> coords, string algorithm,
+                SearchOptions options = SearchOptions())
+            : DroneProblem(n, d, PackageGrid(n, countPackages(n, coords)), algorithm, options) {}
+
+    vector<Action> actions(const State &state) {
         vector<Action> eligibleActions;
         int startingRow = (state.empty()) ? 0 : (state[state.size() - 1].first + 1);
         int endRow = n - (d - state.size());
@@ -296,24 +2552,70 @@ public:
         return eligibleActions;
     }
 
-    State step(State state, Action action) {
+    State step(const State &state, Action action) {
         State nextState(state);
         nextState.push_back(action);
         return nextState;
     }
 
     int solve() {
+        // only dfs and pdfs keep an incumbent to answer with early
+        SearchBudget budget(options.timeLimit, options.maxExpansions, options.progressInterval, label);
+        bool isBudgeted = options.timeLimit > 0 || options.maxExpansions > 0 || options.progressInterval > 0;
+        if(isBudgeted && algorithm != "dfs" && algorithm != "pdfs") {
+            throw invalid_argument("time, nodes and progress only apply to dfs and pdfs.");
+        }
         if(algorithm == "dfs") {
-            return DfsSolver(this).solve();
+            return solveDfs(isBudgeted ? &budget : nullptr);
+        }
+        else if(algorithm == "pdfs") {
+            return solveParallelDfs(isBudgeted ? &budget : nullptr);
         }
         else if(algorithm == "astar") {
-            return AstarSolver(this).solve();
+            return runSolver(AstarSolver<DroneProblem>(this, -1, options.reportOccupancy));
+        }
+        else if(algorithm == "idastar") {
+            return runSolver(IdaStarSolver<DroneProblem>(this, options.memoryBudget << 20, options.reportOccupancy));
+        }
+        else if(algorithm == "memo") {
+            return solveMemo();
         }
         
-        throw invalid_argument("algorithm must be dfs or astar.");
+        throw invalid_argument("algorithm must be dfs, pdfs, astar, idastar or memo.");
+    }
+
+    /* Label of the diagnostic lines of solve(), e.g. the input of a batch
+     * search, so that lines of concurrent searches can be told apart. */
+    void setLabel(string label) {
+        this->label = label;
+    }
+
+    const string& getLabel() {
+        return label;
+    }
+
+    /* Nodes expanded by the last call to solve(). */
+    long long getNumExpansions() {
+        return stats.numExpansions;
+    }
+
+    /* Most nodes the last call to solve() held in its frontier at once. */
+    long long getPeakFrontier() {
+        return stats.peakFrontier;
+    }
+
+    /* Counters of the last call to solve(). */
+    const SearchStats& getStats() {
+        return stats;
+    }
+
+    /* Proven upper bound on the answer of the last call to solve(), above
+     * the answer when the budget ran out before the search completed. */
+    int getUpperBound() {
+        return upperBound;
     }
 
-    int getNumPackagesCollected(State state) {
+    int getNumPackagesCollected(const State &state) {
         int numCollected = 0;
         for(Drone drone : state) {
             numCollected += getXY(drone);
@@ -321,16 +2623,15 @@ public:
         return numCollected;
     }
 
-    int getNumEligiblePackages(State state) {
-        vector< vector<bool> > covered = getCovered(state);
-        int eRow = getNumEligiblePackages(state, covered, "row");
-        int eCol = getNumEligiblePackages(state, covered, "col");
-        int eDiag1 = getNumEligiblePackages(state, covered, "diag1");
-        int eDiag2 = getNumEligiblePackages(state, covered, "diag2");
-        return min(min(eRow, eCol), min(eDiag1, eDiag2));
+    int getNumEligiblePackages(const State &state) {
+        EligibleBound bound = eligibleBound;
+        for(Drone drone : state) {
+            bound.place(drone.first, drone.second);
+        }
+        return bound.getBound(d - state.size());
     }
 
-    string getStateString(State state) {
+    string getStateString(const State &state) {
         stringstream ss;
         ss << "Placed: " << setw(3) << state.size() << endl;
         ss << "Left: " << setw(3) << d - state.size() << endl;
@@ -353,18 +2654,128 @@ public:
     }
 
     const int getXY(Coord coord) {
-        auto it = packages.find(coord);
-        return (it != packages.end()) ? it->second : 0;
+        return onBoard(coord) ? packages.get(coord.first, coord.second) : 0;
+    }
+
+    const PackageGrid& getPackageGrid() {
+        return packages;
+    }
+
+    const vector<Symmetry>& getSymmetries() {
+        return symmetries;
     }
 
 private:
     int n; // board size
     int d; // number of drones
     // vector<Action> actionPriority;
-    unordered_map<Coord, int, CoordHash> packages; // list of coordinates
+    PackageGrid packages; // package count of every cell
+    vector<Symmetry> symmetries; // symmetries of the package layout
+    EligibleBound eligibleBound; // bound of the empty board
     string algorithm;
+    SearchOptions options;
+    string label; // starts the diagnostic lines, empty outside batches
+    SearchStats stats;
+    int upperBound = 0;
+
+    /* Solve and remember the solver's counters and the bound it proved,
+     * sampling the counters meanwhile if asked to. */
+    template<typename S>
+    int runSolver(S &&solver) {
+        int res;
+        {
+            StatsSampler sampler(options.sampleInterval, [&solver]() { return solver.getStats(); }, label);
+            res = solver.solve();
+        }
+        stats = solver.getStats();
+        upperBound = solver.getUpperBound();
+        if(options.dumpStats) {
+            writeError(stats.toJson(), label);
+        }
+        return res;
+    }
+
+    /* Pick the narrowest coverage width that fits the board. */
+    int solveDfs(SearchBudget *budget) {
+        if(n <= 32) {
+            return runSolver(DfsSolver<DroneProblem, 32>(this, nullptr, options.beamWidth, budget));
+        }
+        else if(n <= 64) {
+            return runSolver(DfsSolver<DroneProblem, 64>(this, nullptr, options.beamWidth, budget));
+        }
+        else if(n <= 128) {
+            return runSolver(DfsSolver<DroneProblem, 128>(this, nullptr, options.beamWidth, budget));
+        }
+        else if(n <= 256) {
+            return runSolver(DfsSolver<DroneProblem, 256>(this, nullptr, options.beamWidth, budget));
+        }
+
+        throw invalid_argument("board size must be at most 256 for dfs.");
+    }
+
+    int solveMemo() {
+        long long memoryBudget = options.memoryBudget << 20;
+        if(n <= 32) {
+            return runSolver(MemoSolver<DroneProblem, 32>(this, memoryBudget, options.beamWidth));
+        }
+        else if(n <= 64) {
+            return runSolver(MemoSolver<DroneProblem, 64>(this, memoryBudget, options.beamWidth));
+        }
+        else if(n <= 128) {
+            return runSolver(MemoSolver<DroneProblem, 128>(this, memoryBudget, options.beamWidth));
+        }
+        else if(n <= 256) {
+            return runSolver(MemoSolver<DroneProblem, 256>(this, memoryBudget, options.beamWidth));
+        }
 
-    vector< vector<bool> > getCovered(State state) {
+        throw invalid_argument("board size must be at most 256 for memo.");
+    }
+
+    int solveParallelDfs(SearchBudget *budget) {
+        if(n <= 32) {
+            return solveParallelDfs(ParallelDfsSolver<DroneProblem, 32>(this, options.numThreads, options.beamWidth, budget));
+        }
+        else if(n <= 64) {
+            return solveParallelDfs(ParallelDfsSolver<DroneProblem, 64>(this, options.numThreads, options.beamWidth, budget));
+        }
+        else if(n <= 128) {
+            return solveParallelDfs(ParallelDfsSolver<DroneProblem, 128>(this, options.numThreads, options.beamWidth, budget));
+        }
+        else if(n <= 256) {
+            return solveParallelDfs(ParallelDfsSolver<DroneProblem, 256>(this, options.numThreads, options.beamWidth, budget));
+        }
+
+        throw invalid_argument("board size must be at most 256 for pdfs.");
+    }
+
+    /* Solve and report how many nodes each thread expanded. */
+    template<int W>
+    int solveParallelDfs(ParallelDfsSolver<DroneProblem, W> &&solver) {
+        int res = runSolver(solver);
+        vector<long long> threadExpansions = solver.getThreadExpansions();
+        for(int t = 0; t < (int) threadExpansions.size(); t++) {
+            stringstream ss;
+            ss << "thread " << t << ": " << threadExpansions[t] << " expansions";
+            writeError(ss.str(), label);
+        }
+        return res;
+    }
+
+    bool onBoard(Coord coord) {
+        return coord.first >= 0 && coord.first < n && coord.second >= 0 && coord.second < n;
+    }
+
+    static vector<int> countPackages(int n, const vector<Coord> &coords) {
+        vector<int> counts(n * n, 0);
+        for(Coord coord : coords) {
+            if(coord.first >= 0 && coord.first < n && coord.second >= 0 && coord.second < n) {
+                counts[coord.first * n + coord.second]++;
+            }
+        }
+        return counts;
+    }
+
+    vector< vector<bool> > getCovered(const State &state) {
         /* n^2 runtime */
         vector< vector<bool> > covered = vector< vector<bool> >(n, vector<bool>(n, false));
         for(Coord coord : state) {
@@ -392,7 +2803,7 @@ private:
     }
 
     /* Check whether a position in the board is covered by a drone. */
-    bool checkCovered(State state, Coord coord) {
+    bool checkCovered(const State &state, Coord coord) {
         for(Drone drone : state) {
             // same row
             if(drone.first == coord.first) return true;
@@ -414,112 +2825,6 @@ private:
         return false;
     }
 
-    int getNumEligiblePackages(State state, vector<vector<bool>> covered, string variation) {
-        priority_queue<int> pq;
-
-        if(variation == "row") {
-            for(int i = 0; i < n; i++) {
-                int maxPackageCount = 0;
-                bool dronePlaced = false;
-                for(int j = 0; j < n; j++) {
-                    Coord coord = make_pair(i, j);
-                    int coordPackageCount = getXY(coord);
-                    if((!covered[i][j]) 
-                        && (coordPackageCount > maxPackageCount)) {
-                        maxPackageCount = coordPackageCount;
-                    }
-                    if(find(state.begin(), state.end(), coord) != state.end()) {
-                        dronePlaced = true;
-                        break;
-                    }
-                }
-                if(!dronePlaced) {
-                    pq.push(maxPackageCount);
-                }
-            }
-        }
-        else if(variation == "col") {
-            for(int j = 0; j < n; j++) {
-                int maxPackageCount = 0;
-                bool dronePlaced = false;
-                for(int i = 0; i < n; i++) {
-                    Coord coord = make_pair(i, j);
-                    int coordPackageCount = getXY(coord);
-                    if((!covered[i][j]) 
-                        && (coordPackageCount > maxPackageCount)) {
-                        maxPackageCount = coordPackageCount;
-                    }
-                    if(find(state.begin(), state.end(), coord) != state.end()) {
-                        dronePlaced = true;
-                        break;
-                    }
-                }
-                if(!dronePlaced) {
-                    pq.push(maxPackageCount);
-                }
-            }
-        }
-        else if(variation == "diag1") {
-            for(int dist = -(n - 1); dist <= (n - 1); dist++) {
-                int maxPackageCount = 0;
-                bool dronePlaced = false;
-                int iMin = max(0, dist);
-                int iMax = min(n - 1, dist + n - 1);
-                for(int i = iMin; i <= iMax; i++) {
-                    int j = i - dist;
-                    Coord coord = make_pair(i, j);
-                    int coordPackageCount = getXY(coord);
-                    if((!covered[i][j]) 
-                        && (coordPackageCount > maxPackageCount)) {
-                        maxPackageCount = coordPackageCount;
-                    }
-                    if(find(state.begin(), state.end(), coord) != state.end()) {
-                        dronePlaced = true;
-                        break;
-                    }
-                }
-                if(!dronePlaced) {
-                    pq.push(maxPackageCount);
-                }
-            }
-        }
-        else if(variation == "diag2") {
-            for(int sum = 0; sum <= 2 * (n - 1); sum++) {
-                int maxPackageCount = 0;
-                bool dronePlaced = false;
-                int iMin = max(0, sum - (n - 1));
-                int iMax = min(n - 1, sum);
-                for(int i = iMin; i <= iMax; i++) {
-                    int j = sum - i;
-                    Coord coord = make_pair(i, j);
-                    int coordPackageCount = getXY(coord);
-                    if((!covered[i][j]) 
-                        && (coordPackageCount > maxPackageCount)) {
-                        maxPackageCount = coordPackageCount;
-                    }
-                    if(find(state.begin(), state.end(), coord) != state.end()) {
-                        dronePlaced = true;
-                        break;
-                    }
-                }
-                if(!dronePlaced) {
-                    pq.push(maxPackageCount);
-                }
-            }
-        }
-        else {
-            throw invalid_argument("algorithm must be in [row, col, diag1, diag2].");
-        }
-
-        int res = 0;
-        int numDronesLeft = d - state.size();
-        for(int i = 0; i < numDronesLeft; i++) {
-            res += pq.top();
-            pq.pop();
-        }
-        return res;
-    }
-
     string separatorString() {
         stringstream ss;
         for(int i = 0; i < n; i++) {
@@ -529,7 +2834,7 @@ private:
         return ss.str();
     }
 
-    string rowString(State state, int i) {
+    string rowString(const State &state, int i) {
         stringstream ss;
         for(int j = 0; j < n; j++) {
             Coord coord = make_pair(i, j);
@@ -550,35 +2855,536 @@ private:
     }
 };
 
-int main(int argc, char *argv[]) {
-    ifstream fin("input.txt");
+/* Reads the numbers and lines of an input without copying it line by line,
+ * either straight out of a buffer that holds all of it, such as a mapped
+ * file, or out of a stream through a buffer that is refilled as it goes. */
+class InputScanner {
+public:
+    InputScanner(const char *begin, const char *end) : pos(begin), end(end), stream(nullptr) {}
+
+    InputScanner(istream &stream, size_t bufferSize = 1 << 20) : stream(&stream), buffer(bufferSize) {
+        pos = end = buffer.data();
+    }
+
+    /* Next integer, skipping whitespace and commas before it. */
+    int nextInt() {
+        while(true) {
+            while(pos < end && isSeparator(*pos)) {
+                pos++;
+            }
+            if(pos < end) {
+                break;
+            }
+            if(!refill()) {
+                throw invalid_argument("input ends early.");
+            }
+        }
+        // no number is split across a refill
+        if(end - pos < MAX_NUMBER_LENGTH) {
+            refill();
+        }
+        int value;
+        from_chars_result result = from_chars(pos, end, value);
+        if(result.ec != errc()) {
+            throw invalid_argument("malformed number in input.");
+        }
+        pos = result.ptr;
+        return value;
+    }
+
+    /* Rest of the current line, without its line break. */
+    string nextLine() {
+        string line;
+        while(true) {
+            const char *lineEnd = (const char*) memchr(pos, '\n', end - pos);
+            if(lineEnd != nullptr) {
+                line.append(pos, lineEnd);
+                pos = lineEnd + 1;
+                break;
+            }
+            line.append(pos, end);
+            pos = end;
+            if(!refill()) {
+                break;
+            }
+        }
+        if(!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        return line;
+    }
+
+private:
+    static const int MAX_NUMBER_LENGTH = 32;
+
+    const char *pos;
+    const char *end;
+    istream *stream; // null when the buffer holds the whole input
+    vector<char> buffer;
+
+    static bool isSeparator(char c) {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == ',';
+    }
+
+    /* Keep the unread bytes and read more after them; false at the end of
+     * the input. */
+    bool refill() {
+        if(stream == nullptr) {
+            return false;
+        }
+        size_t numLeft = end - pos;
+        memmove(buffer.data(), pos, numLeft);
+        stream->read(buffer.data() + numLeft, buffer.size() - numLeft);
+        size_t numRead = stream->gcount();
+        pos = buffer.data();
+        end = pos + numLeft + numRead;
+        return numRead > 0;
+    }
+};
 
-    int n, d, p;
-    fin >> n >> d >> p;
+/* Read a problem in the input.txt format, counting packages straight into
+ * the grid. */
+DroneProblem loadProblem(InputScanner &scanner) {
+    int n = scanner.nextInt();
+    int d = scanner.nextInt();
+    int p = scanner.nextInt();
+    if(n < 0 || p < 0) {
+        throw invalid_argument("board size and package count must not be negative.");
+    }
 
     // read past endline
-    string line;
-    getline(fin, line);
+    scanner.nextLine();
 
+    // algorithm, optionally followed by search options
     string algorithm;
-    getline(fin, algorithm);
+    SearchOptions options;
+    stringstream ss(scanner.nextLine());
+    ss >> algorithm;
+    string option;
+    while(ss >> option) {
+        options.set(option);
+    }
+
+    vector<int> counts(n * n, 0);
+    for(int k = 0; k < p; k++) {
+        int x = scanner.nextInt();
+        int y = scanner.nextInt();
+        if(x >= 0 && x < n && y >= 0 && y < n) {
+            counts[x * n + y]++;
+        }
+    }
+
+    return DroneProblem(n, d, PackageGrid(n, counts), algorithm, options);
+}
+
+/* Parse an input from a stream, e.g. a pipe, a chunk at a time. */
+DroneProblem loadProblem(istream &fin) {
+    InputScanner scanner(fin);
+    return loadProblem(scanner);
+}
+
+/* Parse an input file, mapping it into memory when possible. */
+DroneProblem loadProblem(string path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if(fd < 0) {
+        throw invalid_argument("cannot open " + path + ".");
+    }
+    struct stat info;
+    if(fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0) {
+        size_t size = info.st_size;
+        void *data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if(data != MAP_FAILED) {
+            close(fd);
+            madvise(data, size, MADV_SEQUENTIAL);
+            try {
+                InputScanner scanner((const char*) data, (const char*) data + size);
+                DroneProblem problem = loadProblem(scanner);
+                munmap(data, size);
+                return problem;
+            }
+            catch(...) {
+                munmap(data, size);
+                throw;
+            }
+        }
+    }
+    close(fd);
+
+    ifstream fin(path);
+    return loadProblem(fin);
+}
+
+string jsonString(string s) {
+    stringstream ss;
+    ss << '"';
+    for(char c : s) {
+        if(c == '"' || c == '\\') {
+            ss << '\\' << c;
+        }
+        else if((unsigned char) c < 0x20) {
+            ss << "\\u" << hex << setw(4) << setfill('0') << (int) c << dec;
+        }
+        else {
+            ss << c;
+        }
+    }
+    ss << '"';
+    return ss.str();
+}
+
+/* Inputs of a batch: the files of a directory in name order, or the paths
+ * listed one per line in a manifest, relative to the manifest. */
+vector<string> getBatchInputs(string path) {
+    vector<string> inputs;
+    if(filesystem::is_directory(path)) {
+        for(const auto &entry : filesystem::directory_iterator(path)) {
+            if(entry.is_regular_file()) {
+                inputs.push_back(entry.path().string());
+            }
+        }
+        sort(inputs.begin(), inputs.end());
+        return inputs;
+    }
+
+    ifstream manifest(path);
+    if(!manifest) {
+        throw invalid_argument("cannot open " + path + ".");
+    }
+    filesystem::path base = filesystem::path(path).parent_path();
+    string line;
+    while(getline(manifest, line)) {
+        if(!line.empty()) {
+            inputs.push_back(filesystem::path(line).is_absolute() ? line : (base / line).string());
+        }
+    }
+    return inputs;
+}
+
+/* Solve every input of a batch on a pool of numThreads workers and print one
+ * JSON line per instance as soon as it is solved. */
+void runBatch(string path, int numThreads) {
+    if(numThreads <= 0) {
+        numThreads = max(1u, thread::hardware_concurrency());
+    }
+    vector<string> inputs = getBatchInputs(path);
+    mutex outputLock;
+    WorkStealingPool pool(numThreads);
+    for(string input : inputs) {
+        pool.submit([input, &outputLock](int) {
+            stringstream ss;
+            ss << "{\"input\": " << jsonString(input);
+            try {
+                DroneProblem problem = loadProblem(input);
+                problem.setLabel(input);
+                auto start = chrono::steady_clock::now();
+                int answer = problem.solve();
+                chrono::duration<double, milli> elapsed = chrono::steady_clock::now() - start;
+                ss << ", \"answer\": " << answer
+                   << ", \"bound\": " << problem.getUpperBound()
+                   << ", \"ms\": " << fixed << setprecision(3) << elapsed.count()
+                   << ", \"expansions\": " << problem.getNumExpansions()
+                   << ", \"peak_frontier\": " << problem.getPeakFrontier()
+                   << ", \"stats\": " << problem.getStats().toJson();
+            }
+            catch(const exception &e) {
+                ss << ", \"error\": " << jsonString(e.what());
+            }
+            ss << "}";
+            lock_guard<mutex> guard(outputLock);
+            cout << ss.str() << endl;
+        });
+    }
+    pool.run();
+}
+
+/* Grid of generated instances to benchmark, see runBench. */
+struct BenchConfig {
+    uint64_t seed = 1;
+    vector<string> families = {"random", "clustered", "diagonal"};
+    vector<int> sizes = {8, 12, 16};
+    vector<int> drones = {4, 8};
+    vector<int> packages = {64, 256};
+    vector<string> algorithms = {"dfs", "astar", "idastar"};
+    string options; // appended to the algorithm line of every run
+    int timeout = 60; // seconds before a run is killed
+};
 
+vector<string> splitList(string list) {
+    vector<string> items;
+    stringstream ss(list);
+    string item;
+    while(getline(ss, item, ',')) {
+        if(!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+vector<int> splitIntList(string list) {
+    vector<int> items;
+    for(string item : splitList(list)) {
+        items.push_back(stoi(item));
+    }
+    return items;
+}
+
+/* Packages of a generated instance. "random" spreads them uniformly,
+ * "clustered" heaps them around a few centers and "diagonal" lines them up
+ * along both diagonals, where drones cover each other the most. Only the
+ * generator's raw output is used, so the same seed gives the same instance
+ * on every platform. */
+vector<Coord> generatePackages(string family, int n, int p, uint64_t seed) {
+    mt19937_64 rng(seed);
     vector<Coord> coords;
-    for(int i = 0; i < p; i++) {
-        getline(fin, line);
-        int delimPosition = line.find(',');
-        int x = stoi(line.substr(0, delimPosition));
-        int y = stoi(line.substr(delimPosition + 1));
-        coords.push_back(make_pair(x, y));
+    if(family == "random") {
+        for(int k = 0; k < p; k++) {
+            coords.push_back(make_pair(rng() % n, rng() % n));
+        }
+    }
+    else if(family == "clustered") {
+        vector<Coord> centers;
+        for(int k = 0; k < max(1, n / 4); k++) {
+            centers.push_back(make_pair(rng() % n, rng() % n));
+        }
+        int spread = max(1, n / 8);
+        for(int k = 0; k < p; k++) {
+            Coord center = centers[rng() % centers.size()];
+            // sum of two uniform offsets, peaked at the center
+            int x = center.first + (int) (rng() % (spread + 1)) - (int) (rng() % (spread + 1));
+            int y = center.second + (int) (rng() % (spread + 1)) - (int) (rng() % (spread + 1));
+            coords.push_back(make_pair(min(n - 1, max(0, x)), min(n - 1, max(0, y))));
+        }
+    }
+    else if(family == "diagonal") {
+        for(int k = 0; k < p; k++) {
+            int i = rng() % n;
+            int j = (rng() % 2 == 0) ? i : n - 1 - i;
+            // one package in four lands next to the diagonal
+            if(rng() % 4 == 0) {
+                j = min(n - 1, max(0, j + ((rng() % 2 == 0) ? -1 : 1)));
+            }
+            coords.push_back(make_pair(i, j));
+        }
+    }
+    else {
+        throw invalid_argument("family must be random, clustered or diagonal.");
+    }
+    return coords;
+}
+
+/* Seed of one instance of the grid, mixed from the grid's seed. */
+uint64_t getInstanceSeed(uint64_t seed, string family, int n, int d, int p) {
+    // std::hash differs between libraries, so hash the family by hand (FNV-1a)
+    uint32_t familyHash = 2166136261u;
+    for(char c : family) {
+        familyHash = (familyHash ^ (unsigned char) c) * 16777619u;
+    }
+    seed_seq seq = {(uint32_t) seed, (uint32_t) (seed >> 32), familyHash,
+                    (uint32_t) n, (uint32_t) d, (uint32_t) p};
+    uint32_t words[2];
+    seq.generate(words, words + 2);
+    return ((uint64_t) words[0] << 32) | words[1];
+}
+
+/* Calls f(family, n, d, p, coords) for every instance of the grid. Boards
+ * with more drones than rows are skipped. */
+void forEachInstance(const BenchConfig &config,
+            function<void(string, int, int, int, const vector<Coord>&)> f) {
+    for(string family : config.families) {
+        for(int n : config.sizes) {
+            for(int d : config.drones) {
+                if(d > n) {
+                    continue;
+                }
+                for(int p : config.packages) {
+                    uint64_t instanceSeed = getInstanceSeed(config.seed, family, n, d, p);
+                    f(family, n, d, p, generatePackages(family, n, p, instanceSeed));
+                }
+            }
+        }
     }
+}
+
+/* Write every instance of the grid to an input file in dir, to be solved
+ * with --batch. */
+void generateInstances(const BenchConfig &config, string dir) {
+    filesystem::create_directories(dir);
+    forEachInstance(config, [&config, &dir](string family, int n, int d, int p, const vector<Coord> &coords) {
+        stringstream name;
+        name << family << "_n" << n << "_d" << d << "_p" << p << "_s" << config.seed << ".txt";
+        ofstream fout(filesystem::path(dir) / name.str());
+        fout << n << endl << d << endl << p << endl;
+        fout << config.algorithms[0];
+        if(!config.options.empty()) {
+            fout << " " << config.options;
+        }
+        fout << endl;
+        for(Coord coord : coords) {
+            fout << coord.first << "," << coord.second << endl;
+        }
+    });
+}
+
+/* Peak resident set size of this process in kilobytes. */
+long long getPeakRss() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    #ifdef __APPLE__
+    return usage.ru_maxrss / 1024;
+    #else
+    return usage.ru_maxrss;
+    #endif
+}
+
+/* Solve every instance of the grid with every algorithm and print one JSON
+ * line per run. Each run gets a process of its own, so its peak RSS is its
+ * own and a run that exceeds the timeout can be killed. */
+void runBench(const BenchConfig &config) {
+    forEachInstance(config, [&config](string family, int n, int d, int p, const vector<Coord> &coords) {
+        for(string algorithm : config.algorithms) {
+            stringstream head;
+            head << "{\"family\": " << jsonString(family) << ", \"n\": " << n << ", \"d\": " << d
+                 << ", \"p\": " << p << ", \"seed\": " << config.seed
+                 << ", \"algorithm\": " << jsonString(algorithm);
+            cout.flush();
+            pid_t pid = fork();
+            if(pid < 0) {
+                throw runtime_error("cannot fork a benchmark run.");
+            }
+            if(pid == 0) {
+                alarm(config.timeout);
+                stringstream ss;
+                ss << head.str();
+                try {
+                    SearchOptions options;
+                    stringstream optionStream(config.options);
+                    string option;
+                    while(optionStream >> option) {
+                        options.set(option);
+                    }
+                    DroneProblem problem(n, d, coords, algorithm, options);
+                    auto start = chrono::steady_clock::now();
+                    int answer = problem.solve();
+                    chrono::duration<double, milli> elapsed = chrono::steady_clock::now() - start;
+                    ss << ", \"answer\": " << answer
+                       << ", \"bound\": " << problem.getUpperBound()
+                       << ", \"ms\": " << fixed << setprecision(3) << elapsed.count()
+                       << ", \"expansions\": " << problem.getNumExpansions()
+                       << ", \"peak_frontier\": " << problem.getPeakFrontier()
+                       << ", \"rss_kb\": " << getPeakRss()
+                       << ", \"stats\": " << problem.getStats().toJson();
+                }
+                catch(const exception &e) {
+                    ss << ", \"error\": " << jsonString(e.what());
+                }
+                ss << "}";
+                cout << ss.str() << endl;
+                _exit(0);
+            }
+            int status;
+            waitpid(pid, &status, 0);
+            if(WIFSIGNALED(status)) {
+                string error = (WTERMSIG(status) == SIGALRM) ? "timeout" : "killed by a signal";
+                cout << head.str() << ", \"error\": " << jsonString(error) << "}" << endl;
+            }
+        }
+    });
+}
 
-    fin.close();
+/* Without arguments, solves input.txt into output.txt; with "-", solves the
+ * input read from stdin instead. With "--batch <directory or manifest> [--threads <n>]", solves
+ * many inputs concurrently and streams the results to stdout as JSON lines.
+ *
+ * "--bench" solves a grid of generated instances one at a time and prints
+ * time, expansions, peak frontier and peak RSS of every run as JSON lines;
+ * "--generate <dir>" writes the same instances as input files instead. The
+ * grid is set with --seed <s>, --families, --sizes, --drones, --packages and
+ * --algorithms (comma-separated lists), --options "<search options>" and
+ * --timeout <seconds>. */
+int main(int argc, char *argv[]) {
+    string batchPath;
+    int numThreads = 0;
+    bool bench = false;
+    string generateDir;
+    BenchConfig benchConfig;
+    bool readStdin = false;
+    for(int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if(arg == "-") {
+            readStdin = true;
+        }
+        else if(arg == "--batch" && i + 1 < argc) {
+            batchPath = argv[++i];
+        }
+        else if(arg == "--threads" && i + 1 < argc) {
+            numThreads = stoi(argv[++i]);
+        }
+        else if(arg == "--bench") {
+            bench = true;
+        }
+        else if(arg == "--generate" && i + 1 < argc) {
+            generateDir = argv[++i];
+        }
+        else if(arg == "--seed" && i + 1 < argc) {
+            benchConfig.seed = stoull(argv[++i]);
+        }
+        else if(arg == "--families" && i + 1 < argc) {
+            benchConfig.families = splitList(argv[++i]);
+        }
+        else if(arg == "--sizes" && i + 1 < argc) {
+            benchConfig.sizes = splitIntList(argv[++i]);
+        }
+        else if(arg == "--drones" && i + 1 < argc) {
+            benchConfig.drones = splitIntList(argv[++i]);
+        }
+        else if(arg == "--packages" && i + 1 < argc) {
+            benchConfig.packages = splitIntList(argv[++i]);
+        }
+        else if(arg == "--algorithms" && i + 1 < argc) {
+            benchConfig.algorithms = splitList(argv[++i]);
+        }
+        else if(arg == "--options" && i + 1 < argc) {
+            benchConfig.options = argv[++i];
+        }
+        else if(arg == "--timeout" && i + 1 < argc) {
+            benchConfig.timeout = stoi(argv[++i]);
+        }
+        else {
+            cerr << "usage: " << argv[0] << " [- | --batch <directory or manifest> [--threads <n>]]" << endl;
+            cerr << "       " << argv[0] << " --bench | --generate <dir> [--seed <s>] [--families <list>]"
+                 << " [--sizes <list>] [--drones <list>] [--packages <list>] [--algorithms <list>]"
+                 << " [--options <options>] [--timeout <seconds>]" << endl;
+            return 1;
+        }
+    }
+    if(!batchPath.empty()) {
+        runBatch(batchPath, numThreads);
+        return 0;
+    }
+    if(!generateDir.empty()) {
+        generateInstances(benchConfig, generateDir);
+        return 0;
+    }
+    if(bench) {
+        runBench(benchConfig);
+        return 0;
+    }
 
-    DroneProblem problem(n, d, coords, algorithm);
+    if(readStdin) {
+        ios::sync_with_stdio(false);
+    }
+    DroneProblem problem = readStdin ? loadProblem(cin) : loadProblem("input.txt");
 
     ofstream fout("output.txt");
 
-    fout << problem.solve() << endl;
+    int answer = problem.solve();
+    fout << answer << endl;
+    if(problem.getUpperBound() > answer) {
+        // the budget ran out first: the answer is the best placement found
+        fout << "upper bound " << problem.getUpperBound()
+             << ", gap " << problem.getUpperBound() - answer << endl;
+    }
 
     fout.close();
 
@@ -2,10 +2,20 @@
 #include <string>
 #include <fstream>
 #include <sstream>
+#include <iomanip>
 #include <algorithm>
 #include <limits>
 #include <vector>
 #include <utility>
+#include <cstdint>
+#include <random>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <functional>
+#include <map>
+#include <stdexcept>
 #include <math.h>
 
 #define MIN(a,b) (((a)<(b))?(a):(b))
@@ -13,9 +23,40 @@
 
 using namespace std;
 
-// global variables
-int numPlayers = 0;
-string algorithm = "";
+// how a DraftEngine searches: "minimax" searches the whole tree, "ab" prunes
+// it with alpha-beta and "pab" prunes it on several threads
+enum SearchMode { MINIMAX, ALPHABETA, PARALLEL_ALPHABETA };
+
+// settings that can follow the algorithm name, e.g. "pab threads=8 memory=64"
+struct SearchOptions {
+    long long tableMemory = 64; // memory: megabytes of transposition table
+    int numThreads = 0; // threads: threads of "pab", 0 for one per core
+
+    void set(string option) {
+        if(option.compare(0, 7, "memory=") == 0) {
+            tableMemory = stoll(option.substr(7));
+        }
+        else if(option.compare(0, 8, "threads=") == 0) {
+            numThreads = stoi(option.substr(8));
+        }
+        else {
+            throw invalid_argument("unknown option " + option.substr(0, option.find('=')) + ".");
+        }
+    }
+};
+
+// mode and options of an algorithm line such as "ab memory=16"; any name
+// but "ab" and "pab" means minimax
+void parseAlgorithm(string line, SearchMode &mode, SearchOptions &options) {
+    stringstream algorithmLine(line);
+    string algorithm;
+    algorithmLine >> algorithm;
+    mode = (algorithm == "ab") ? ALPHABETA : (algorithm == "pab") ? PARALLEL_ALPHABETA : MINIMAX;
+    string option;
+    while(algorithmLine >> option) {
+        options.set(option);
+    }
+}
 
 struct Player {
     int id;
@@ -25,96 +66,555 @@ struct Player {
     int team;
 };
 
-// each player is represented by (id, c, h1, h2, team)
-vector<Player> players;
-int aCount = 0;
-int bCount = 0;
+enum Bound { EMPTY, EXACT, LOWER, UPPER };
+
+struct TableEntry {
+    uint64_t key;
+    double score;
+    int bestIndex; // index in players of the best pick
+    int depth; // picks searched below the position
+    Bound bound; // whether score is exact or a lower or upper bound
+    uint32_t generation; // position whose search stored the entry
+};
+
+// search of a draft position: the players and their teams, the running
+// evaluation, the transposition table and the move ordering. Searches share
+// nothing, so several can run at once from copies of one position, and one
+// can be reused for the next position without clearing its table.
+class DraftSearch {
+public:
+    // memory is the most the transposition table may take, in bytes. The
+    // table starts small and doubles as a position fills it, so that small
+    // drafts do not pay for clearing a large one.
+    DraftSearch(SearchMode mode, long long memory) : useTable(mode != MINIMAX) {
+        maxTableSize = 1;
+        while(useTable && 2 * maxTableSize * (long long) sizeof(TableEntry) <= memory) {
+            maxTableSize <<= 1;
+        }
+        table = vector<TableEntry>(MIN(maxTableSize, INITIAL_TABLE_SIZE), EMPTY_ENTRY);
+    }
+
+    void setPosition(const vector<Player> &players) {
+        this->players = players;
+        numPlayers = players.size();
+        aCount = 0;
+        bCount = 0;
+        for(Player player : players) {
+            if(player.team == 1) {
+                aCount++;
+            }
+            else if(player.team == 2) {
+                bCount++;
+            }
+        }
+        initEvaluation();
+        initTable();
+    }
+
+    // score of team a picking player i, searched depth picks deep in total
+    double searchPick(int i, double alpha, double beta, int depth) {
+        assign(i, 1);
+        aCount++;
+        double score = alphabeta(alpha, beta, false, depth - 1).second;
+        aCount--;
+        unassign(i);
+        return score;
+    }
+
+    const vector<Player>& getPlayers() {
+        return players;
+    }
+
+    int getPicksLeft() {
+        return (5 - aCount) + (5 - bCount);
+    }
+
+private:
+    // each player is represented by (id, c, h1, h2, team)
+    vector<Player> players;
+    int numPlayers = 0;
+    int aCount = 0;
+    int bCount = 0;
+    bool useTable; // prune, with the table and move ordering, or search it all
 
-double heuristic() {
-    int aIds[10] = {0};
+    // running evaluation of the teams, updated as players are assigned. The
+    // assigned players are kept in input order, so that a score adds up their
+    // gains in the same order, and rounds the same way, whatever the order of
+    // the picks that led to it.
+    vector<double> aGains; // h1 * c of each player
+    vector<double> bGains; // h2 * c of each player
+    vector<uint64_t> assigned; // bit i % 64 of word i / 64 is set when player i is on a team
+    int aIds[10] = {0}; // players of each team by id % 10
     int bIds[10] = {0};
-    double score = 0.0;
-    bool ad = true; // a team is diverse
-    bool bd = true; // b team is diverse
-    for(Player player : players) {
-        if(player.team == 1) {
-            score += player.h1 * player.c;
-            aIds[player.id % 10]++;
-            if(aIds[player.id % 10] > 1) {
-                ad = false;
+    int aDuplicates = 0; // players of a team sharing their id % 10 with another
+    int bDuplicates = 0;
+
+    static constexpr long long INITIAL_TABLE_SIZE = 1024;
+    static constexpr TableEntry EMPTY_ENTRY = {0, 0.0, -1, 0, EMPTY, 0};
+    vector<TableEntry> table;
+    long long maxTableSize; // entries the table may grow to
+    long long numStored = 0; // entries stored for this position
+    // random key of each player joining each team; the key of a position is the
+    // xor of its picks' keys, and of sideKey when team b is to pick
+    vector<uint64_t> teamKeys[3];
+    uint64_t sideKey = 0;
+    uint64_t positionKey = 0;
+    uint32_t generation = 0; // entries of other generations are empty
+
+    // move ordering: the two latest picks that caused a cutoff at each number
+    // of picks made, and a history score of each player joining each team,
+    // raised whenever that pick causes a cutoff
+    int killers[11][2];
+    vector<long long> history[3];
+    vector<int> pickLists[11]; // picks of the node being searched at each ply
+
+    void addPlayer(int i, int team) {
+        int digit = players[i].id % 10;
+        assigned[i >> 6] |= 1ULL << (i & 63);
+        if(team == 1) {
+            if(++aIds[digit] > 1) {
+                aDuplicates++;
             }
         }
-        else if(player.team == 2) {
-            score -= player.h2 * player.c;
-            bIds[player.id % 10]++;
-            if(bIds[player.id % 10] > 1) {
-                bd = false;
+        else {
+            if(++bIds[digit] > 1) {
+                bDuplicates++;
             }
         }
     }
-    if(ad) score += 120.0;
-    if(bd) score -= 120.0;
-    return score;
-}
 
-pair<int, double> alphabeta(double alpha, double beta, bool maximizing) {
-    if(aCount == 5 && bCount == 5) {
-        return make_pair(0, heuristic());
+    void removePlayer(int i, int team) {
+        int digit = players[i].id % 10;
+        assigned[i >> 6] &= ~(1ULL << (i & 63));
+        if(team == 1) {
+            if(aIds[digit]-- > 1) {
+                aDuplicates--;
+            }
+        }
+        else {
+            if(bIds[digit]-- > 1) {
+                bDuplicates--;
+            }
+        }
     }
 
-    double score;
-    int bestId;
-
-    if(maximizing) {
-        score = -INFINITY;
+    // evaluate the players already assigned
+    void initEvaluation() {
+        aGains.clear();
+        bGains.clear();
+        for(Player player : players) {
+            aGains.push_back(player.h1 * player.c);
+            bGains.push_back(player.h2 * player.c);
+        }
+        assigned.assign((numPlayers + 63) / 64, 0);
+        fill(aIds, aIds + 10, 0);
+        fill(bIds, bIds + 10, 0);
+        aDuplicates = 0;
+        bDuplicates = 0;
         for(int i = 0; i < numPlayers; i++) {
-            Player player = players[i];
-            if(player.team != 0) {
-                continue;
+            if(players[i].team != 0) {
+                addPlayer(i, players[i].team);
             }
-            players[i].team = 1;
-            aCount++;
-            double currScore = alphabeta(alpha, beta, false).second;
-            if(currScore > score || (currScore == score && player.id < bestId)) {
-                bestId = player.id;
-                score = currScore;
+        }
+    }
+
+    void initTable() {
+        mt19937_64 rng(0x2545f4914f6cdd1dULL);
+        for(int team = 1; team <= 2; team++) {
+            teamKeys[team].clear();
+            for(int i = 0; i < numPlayers; i++) {
+                teamKeys[team].push_back(rng());
             }
-            alpha = MAX(alpha, score);
-            aCount--;
-            players[i].team = 0;
-            if(alpha >= beta && algorithm == "ab") {
-                break;
+        }
+        sideKey = rng();
+        positionKey = 0;
+        for(int i = 0; i < numPlayers; i++) {
+            if(players[i].team != 0) {
+                positionKey ^= teamKeys[players[i].team][i];
+            }
+        }
+
+        if(++generation == 0) {
+            fill(table.begin(), table.end(), EMPTY_ENTRY);
+            generation = 1;
+        }
+        numStored = 0;
+
+        for(int ply = 0; ply <= 10; ply++) {
+            killers[ply][0] = killers[ply][1] = -1;
+        }
+        for(int team = 1; team <= 2; team++) {
+            history[team] = vector<long long>(numPlayers, 0);
+        }
+    }
+
+    void assign(int i, int team) {
+        players[i].team = team;
+        positionKey ^= teamKeys[team][i];
+        addPlayer(i, team);
+    }
+
+    void unassign(int i) {
+        removePlayer(i, players[i].team);
+        positionKey ^= teamKeys[players[i].team][i];
+        players[i].team = 0;
+    }
+
+    double heuristic() {
+        double score = 0.0;
+        for(int word = 0; word < (int) assigned.size(); word++) {
+            for(uint64_t bits = assigned[word]; bits != 0; bits &= bits - 1) {
+                int i = word * 64 + __builtin_ctzll(bits);
+                if(players[i].team == 1) {
+                    score += aGains[i];
+                }
+                else {
+                    score -= bGains[i];
+                }
             }
         }
+        if(aDuplicates == 0) score += 120.0; // a team is diverse
+        if(bDuplicates == 0) score -= 120.0; // b team is diverse
+        return score;
+    }
+
+    // what a pick adds to its team's side of the score right away: h * c, less
+    // the diversity bonus if it repeats an id % 10 of a team still diverse
+    double getMarginal(int i, int team) {
+        int digit = players[i].id % 10;
+        if(team == 1) {
+            return players[i].h1 * players[i].c - ((aDuplicates == 0 && aIds[digit] > 0) ? 120.0 : 0.0);
+        }
+        return players[i].h2 * players[i].c - ((bDuplicates == 0 && bIds[digit] > 0) ? 120.0 : 0.0);
     }
-    else {
-        score = INFINITY;
+
+    // the free players in the order a node tries them when pruning: the
+    // table's best pick, the killer picks of the ply, then by history and by
+    // marginal gain; "minimax" tries them in input order
+    const vector<int>& orderPicks(int ply, int team, int tableIndex) {
+        vector<int> &picks = pickLists[ply];
+        picks.clear();
         for(int i = 0; i < numPlayers; i++) {
-            Player player = players[i];
-            if(player.team != 0) {
-                continue;
+            if(players[i].team == 0) {
+                picks.push_back(i);
+            }
+        }
+        if(!useTable) {
+            return picks;
+        }
+
+        vector< pair< pair<int, long long>, double > > keys(numPlayers);
+        for(int i : picks) {
+            int priority = (i == tableIndex) ? 3 : (i == killers[ply][0]) ? 2 : (i == killers[ply][1]) ? 1 : 0;
+            keys[i] = make_pair(make_pair(priority, history[team][i]), getMarginal(i, team));
+        }
+        stable_sort(picks.begin(), picks.end(), [&keys](int i1, int i2) {
+            return keys[i1] > keys[i2];
+        });
+        return picks;
+    }
+
+    // store an entry, doubling the table first when it would be over half
+    // full of entries of this position and may still grow
+    void store(const TableEntry &newEntry) {
+        TableEntry *slot = &table[newEntry.key & (table.size() - 1)];
+        if(slot->generation != generation && 2 * ++numStored > (long long) table.size()
+            && (long long) table.size() < maxTableSize) {
+            vector<TableEntry> oldTable(2 * table.size(), EMPTY_ENTRY);
+            table.swap(oldTable);
+            for(const TableEntry &entry : oldTable) {
+                if(entry.generation == generation) {
+                    table[entry.key & (table.size() - 1)] = entry;
+                }
+            }
+            slot = &table[newEntry.key & (table.size() - 1)];
+        }
+        *slot = newEntry;
+    }
+
+    void recordCutoff(int ply, int team, int i, int depth) {
+        if(killers[ply][0] != i) {
+            killers[ply][1] = killers[ply][0];
+            killers[ply][0] = i;
+        }
+        history[team][i] += (long long) depth * depth;
+    }
+
+    // score of the position searched depth picks deep, or to the end of the
+    // draft if that comes first. When pruning, the first pick of a node is
+    // searched with the full window and the others with a null window just
+    // above alpha (below beta for team b), searched again with the full
+    // window only if they turn out better than the first (principal-variation
+    // search).
+    pair<int, double> alphabeta(double alpha, double beta, bool maximizing, int depth) {
+        if((aCount == 5 && bCount == 5) || depth == 0) {
+            return make_pair(0, heuristic());
+        }
+
+        // a score within (alpha, beta) is exact; one at or beyond either end is
+        // a bound on the exact score, which is beyond it too
+        uint64_t key = maximizing ? positionKey : positionKey ^ sideKey;
+        const TableEntry &entry = table[key & (table.size() - 1)];
+        int tableIndex = -1;
+        if(useTable && entry.generation == generation && entry.key == key) {
+            if(entry.depth >= depth && (entry.bound == EXACT
+                || (entry.bound == LOWER && entry.score >= beta)
+                || (entry.bound == UPPER && entry.score <= alpha))) {
+                return make_pair(players[entry.bestIndex].id, entry.score);
             }
-            players[i].team = 2;
-            bCount++;
-            double currScore = alphabeta(alpha, beta, true).second;
-            if(currScore < score || (currScore == score && player.id < bestId)) {
-                bestId = player.id;
-                score = currScore;
+            tableIndex = entry.bestIndex;
+        }
+        double alphaOrig = alpha;
+        double betaOrig = beta;
+
+        double score;
+        int bestId = -1;
+        int bestIndex = -1;
+        int ply = aCount + bCount;
+
+        if(maximizing) {
+            score = -INFINITY;
+            const vector<int> &picks = orderPicks(ply, 1, tableIndex);
+            for(int k = 0; k < (int) picks.size(); k++) {
+                int i = picks[k];
+                Player player = players[i];
+                assign(i, 1);
+                aCount++;
+                double currScore;
+                if(k == 0 || !useTable) {
+                    currScore = alphabeta(alpha, beta, false, depth - 1).second;
+                }
+                else {
+                    currScore = alphabeta(alpha, nextafter(alpha, INFINITY), false, depth - 1).second;
+                    if(currScore > alpha && currScore < beta) {
+                        currScore = alphabeta(alpha, beta, false, depth - 1).second;
+                    }
+                }
+                if(currScore > score || (currScore == score && player.id < bestId)) {
+                    bestId = player.id;
+                    bestIndex = i;
+                    score = currScore;
+                }
+                alpha = MAX(alpha, score);
+                aCount--;
+                unassign(i);
+                if(alpha >= beta && useTable) {
+                    recordCutoff(ply, 1, i, depth);
+                    break;
+                }
             }
-            beta = MIN(beta, score);
-            bCount--;
-            players[i].team = 0;
-            if(alpha >= beta && algorithm == "ab") {
-                break;
+        }
+        else {
+            score = INFINITY;
+            const vector<int> &picks = orderPicks(ply, 2, tableIndex);
+            for(int k = 0; k < (int) picks.size(); k++) {
+                int i = picks[k];
+                Player player = players[i];
+                assign(i, 2);
+                bCount++;
+                double currScore;
+                if(k == 0 || !useTable) {
+                    currScore = alphabeta(alpha, beta, true, depth - 1).second;
+                }
+                else {
+                    currScore = alphabeta(nextafter(beta, -INFINITY), beta, true, depth - 1).second;
+                    if(currScore < beta && currScore > alpha) {
+                        currScore = alphabeta(alpha, beta, true, depth - 1).second;
+                    }
+                }
+                if(currScore < score || (currScore == score && player.id < bestId)) {
+                    bestId = player.id;
+                    bestIndex = i;
+                    score = currScore;
+                }
+                beta = MIN(beta, score);
+                bCount--;
+                unassign(i);
+                if(alpha >= beta && useTable) {
+                    recordCutoff(ply, 2, i, depth);
+                    break;
+                }
             }
         }
+
+        if(useTable && bestIndex >= 0) {
+            Bound bound = (score <= alphaOrig) ? UPPER : (score >= betaOrig) ? LOWER : EXACT;
+            store({key, score, bestIndex, depth, bound, generation});
+        }
+        return make_pair(bestId, score);
     }
+};
 
-    return make_pair(bestId, score);
+// run task(k, worker) for every k below count on numWorkers threads, each
+// taking the next k as soon as it finishes one
+void forEachParallel(int count, int numWorkers, function<void(int, int)> task) {
+    atomic<int> next(0);
+    auto work = [&](int worker) {
+        for(int k = next++; k < count; k = next++) {
+            task(k, worker);
+        }
+    };
+    if(numWorkers <= 1) {
+        work(0);
+        return;
+    }
+    vector<thread> threads;
+    for(int t = 0; t < numWorkers; t++) {
+        threads.push_back(thread(work, t));
+    }
+    for(thread &worker : threads) {
+        worker.join();
+    }
 }
 
-int main() {
-    ifstream fin("input.txt");
+// best pick of the root found so far, shared by the threads searching it
+struct RootBest {
+    mutex lock;
+    double score = -INFINITY;
+    int bestId = -1;
+
+    // lower end of the window of player, which only has to tie with the best
+    // pick if it has a lower id, so the window starts just below its score;
+    // a score above it is exact
+    double getAlpha(const Player &player) {
+        lock_guard<mutex> guard(lock);
+        return (player.id < bestId) ? nextafter(score, -INFINITY) : score;
+    }
+
+    void update(const Player &player, double currScore) {
+        lock_guard<mutex> guard(lock);
+        if(bestId < 0 || currScore > score || (currScore == score && player.id < bestId)) {
+            bestId = player.id;
+            score = currScore;
+        }
+    }
+};
+
+// finds team a's best pick in draft positions. The mode is fixed when the
+// engine is made, and a call keeps all of its state in searches it borrows
+// from the engine, so any number of threads may call it at once.
+class DraftEngine {
+public:
+    DraftEngine(SearchMode mode, SearchOptions options = SearchOptions()) : mode(mode) {
+        numThreads = 1;
+        if(mode == PARALLEL_ALPHABETA) {
+            numThreads = (options.numThreads > 0) ? options.numThreads : MAX(1, (int) thread::hardware_concurrency());
+        }
+        // "pab" splits the memory between its threads' tables
+        searchMemory = (options.tableMemory << 20) / numThreads;
+    }
+
+    // id of team a's best pick, the lowest id among equally good ones. "ab"
+    // and "pab" deepen their search one pick at a time, so that each search
+    // is ordered by the table, killers and history of the last.
+    int getBestId(const vector<Player> &players) {
+        vector< unique_ptr<DraftSearch> > searches;
+        for(int t = 0; t < numThreads; t++) {
+            searches.push_back(acquireSearch());
+            searches[t]->setPosition(players);
+        }
+
+        int res = 0;
+        int picksLeft = searches[0]->getPicksLeft();
+        vector<int> rootPicks;
+        for(int i = 0; i < (int) players.size(); i++) {
+            if(players[i].team == 0) {
+                rootPicks.push_back(i);
+            }
+        }
+        if(picksLeft > 0 && !rootPicks.empty()) {
+            if(mode != MINIMAX) {
+                for(int depth = 1; depth < picksLeft; depth++) {
+                    searchRoot(searches, rootPicks, depth);
+                }
+            }
+            res = searchRoot(searches, rootPicks, picksLeft);
+        }
+
+        for(unique_ptr<DraftSearch> &search : searches) {
+            releaseSearch(move(search));
+        }
+        return res;
+    }
+
+private:
+    SearchMode mode;
+    int numThreads; // searches of one position
+    long long searchMemory; // bytes of each search's table
+    mutex freeLock;
+    vector< unique_ptr<DraftSearch> > freeSearches; // searches not in use
+
+    unique_ptr<DraftSearch> acquireSearch() {
+        lock_guard<mutex> guard(freeLock);
+        if(freeSearches.empty()) {
+            return unique_ptr<DraftSearch>(new DraftSearch(mode, searchMemory));
+        }
+        unique_ptr<DraftSearch> search = move(freeSearches.back());
+        freeSearches.pop_back();
+        return search;
+    }
+
+    void releaseSearch(unique_ptr<DraftSearch> search) {
+        lock_guard<mutex> guard(freeLock);
+        freeSearches.push_back(move(search));
+    }
+
+    // score of a root pick on one search. When pruning, a null window first
+    // tells whether the pick can be better than the best so far at all.
+    double searchRootPick(DraftSearch &search, RootBest &best, int i, int depth) {
+        const Player &player = search.getPlayers()[i];
+        double alpha = best.getAlpha(player);
+        if(alpha == -INFINITY || mode == MINIMAX) {
+            return search.searchPick(i, alpha, INFINITY, depth);
+        }
+        double currScore = search.searchPick(i, alpha, nextafter(alpha, INFINITY), depth);
+        if(currScore > alpha) {
+            // the best may have improved meanwhile, which only narrows the window
+            alpha = best.getAlpha(player);
+            currScore = search.searchPick(i, alpha, INFINITY, depth);
+        }
+        return currScore;
+    }
+
+    // id of team a's best pick searched depth picks deep, the lowest id among
+    // equally good ones, trying the picks in the order of rootPicks and then
+    // sorting them by score for the next search. The first pick is searched
+    // alone; the others are then shared out to one thread per search, and
+    // all windows start from the best pick so far. Any order of the picks
+    // finds the same best pick, as its score is exact and beats or ties
+    // every other one.
+    int searchRoot(vector< unique_ptr<DraftSearch> > &searches, vector<int> &rootPicks, int depth) {
+        RootBest best;
+        const vector<Player> &players = searches[0]->getPlayers();
+        vector<double> scores(players.size());
+        scores[rootPicks[0]] = searchRootPick(*searches[0], best, rootPicks[0], depth);
+        best.update(players[rootPicks[0]], scores[rootPicks[0]]);
+
+        forEachParallel(rootPicks.size() - 1, searches.size(), [&](int k, int worker) {
+            int i = rootPicks[k + 1];
+            scores[i] = searchRootPick(*searches[worker], best, i, depth);
+            best.update(players[i], scores[i]);
+        });
+
+        stable_sort(rootPicks.begin(), rootPicks.end(), [&scores](int i1, int i2) {
+            return scores[i1] > scores[i2];
+        });
+        return best.bestId;
+    }
+};
+
+// one position of a batch, with what to search it with and a tag for its
+// answer; error is set instead if it could not be read
+struct DraftQuery {
+    string tag; // JSON value of the query's "input" in the answer
+    string algorithm;
+    vector<Player> players;
+    string error;
+};
+
+// read a position in the format of input.txt
+void readInput(istream &fin, string &algorithm, vector<Player> &players) {
+    int numPlayers = 0;
     fin >> numPlayers;
     string line;
     getline(fin, line);
@@ -127,20 +627,351 @@ int main() {
         char ch;
         ss >> id >> ch >> c >> ch >> h1 >> ch >> h2 >> ch >> team;
         players.push_back({id, c, h1, h2, team});
-        if(team == 1) {
-            aCount++;
+    }
+}
+
+string jsonString(string s) {
+    stringstream ss;
+    ss << '"';
+    for(char c : s) {
+        if(c == '"' || c == '\\') {
+            ss << '\\' << c;
+        }
+        else if((unsigned char) c < 0x20) {
+            ss << "\\u" << hex << setw(4) << setfill('0') << (int) c << dec;
+        }
+        else {
+            ss << c;
+        }
+    }
+    ss << '"';
+    return ss.str();
+}
+
+// reader of one JSON query, e.g.
+// {"id": 7, "algorithm": "ab", "players": [[17, 0.5, 90, 80, 0], ...]}
+// where each player is [id, c, h1, h2, team]; other keys are skipped
+class QueryParser {
+public:
+    QueryParser(const string &text) : text(text), pos(0) {}
+
+    // algorithm and tag are only set if the query has them
+    void parse(vector<Player> &players, string &algorithm, string &tag) {
+        expect('{');
+        if(peek() == '}') {
+            pos++;
+            return;
+        }
+        while(true) {
+            string key = parseString();
+            expect(':');
+            if(key == "players") {
+                parsePlayers(players);
+            }
+            else if(key == "algorithm") {
+                algorithm = parseString();
+            }
+            else if(key == "id") {
+                tag = skipValue();
+            }
+            else {
+                skipValue();
+            }
+            if(peek() == ',') {
+                pos++;
+                continue;
+            }
+            expect('}');
+            return;
+        }
+    }
+
+private:
+    const string &text;
+    size_t pos;
+
+    char peek() {
+        while(pos < text.size() && isspace((unsigned char) text[pos])) {
+            pos++;
+        }
+        return (pos < text.size()) ? text[pos] : '\0';
+    }
+
+    void expect(char c) {
+        if(peek() != c) {
+            throw invalid_argument(string("expected '") + c + "' at " + to_string(pos) + ".");
         }
-        else if(team == 2) {
-            bCount++;
+        pos++;
+    }
+
+    string parseString() {
+        expect('"');
+        string res;
+        while(pos < text.size() && text[pos] != '"') {
+            if(text[pos] == '\\' && pos + 1 < text.size()) {
+                pos++;
+            }
+            res += text[pos++];
+        }
+        expect('"');
+        return res;
+    }
+
+    double parseNumber() {
+        peek();
+        const char *begin = text.c_str() + pos;
+        char *end;
+        double value = strtod(begin, &end);
+        if(end == begin) {
+            throw invalid_argument("expected a number at " + to_string(pos) + ".");
         }
+        pos += end - begin;
+        return value;
     }
 
+    // skip any value and return its text
+    string skipValue() {
+        char c = peek();
+        size_t begin = pos;
+        if(c == '"') {
+            parseString();
+        }
+        else if(c == '[' || c == '{') {
+            int nesting = 0;
+            do {
+                if(text[pos] == '"') {
+                    parseString();
+                    continue;
+                }
+                if(text[pos] == '[' || text[pos] == '{') nesting++;
+                if(text[pos] == ']' || text[pos] == '}') nesting--;
+                pos++;
+            } while(nesting > 0 && pos < text.size());
+        }
+        else {
+            while(pos < text.size() && text[pos] != ',' && text[pos] != '}' && text[pos] != ']'
+                && !isspace((unsigned char) text[pos])) {
+                pos++;
+            }
+        }
+        if(pos == begin) {
+            throw invalid_argument("expected a value at " + to_string(pos) + ".");
+        }
+        return text.substr(begin, pos - begin);
+    }
+
+    void parsePlayers(vector<Player> &players) {
+        expect('[');
+        if(peek() == ']') {
+            pos++;
+            return;
+        }
+        while(true) {
+            expect('[');
+            double fields[5];
+            for(int f = 0; f < 5; f++) {
+                if(f > 0) {
+                    expect(',');
+                }
+                fields[f] = parseNumber();
+            }
+            expect(']');
+            int team = (int) fields[4];
+            if(team != fields[4] || team < 0 || team > 2) {
+                throw invalid_argument("team must be 0, 1 or 2.");
+            }
+            players.push_back({(int) fields[0], fields[1], fields[2], fields[3], team});
+            if(peek() == ',') {
+                pos++;
+                continue;
+            }
+            expect(']');
+            return;
+        }
+    }
+};
+
+// evaluates many draft positions at once, each with its own algorithm line,
+// keeping one DraftEngine per line for every batch it is given
+class DraftService {
+public:
+    // numWorkers positions are searched at a time, 0 for one per core
+    DraftService(int numWorkers = 0) : numWorkers(numWorkers) {
+        if(this->numWorkers <= 0) {
+            this->numWorkers = MAX(1, (int) thread::hardware_concurrency());
+        }
+    }
+
+    // best pick of every query, or -1 for one whose error is set, either
+    // when it was read or now if its algorithm line is bad. The engines are
+    // all made, and looked up, before the searches start.
+    vector<int> getBestIds(vector<DraftQuery> &queries) {
+        vector<DraftEngine*> queryEngines(queries.size(), nullptr);
+        for(int k = 0; k < (int) queries.size(); k++) {
+            DraftQuery &query = queries[k];
+            if(query.error.empty()) {
+                try {
+                    queryEngines[k] = getEngine(query.algorithm);
+                }
+                catch(const exception &e) {
+                    query.error = e.what();
+                }
+            }
+        }
+        vector<int> res(queries.size(), -1);
+        forEachParallel(queries.size(), numWorkers, [&](int k, int) {
+            if(queryEngines[k] != nullptr) {
+                res[k] = queryEngines[k]->getBestId(queries[k].players);
+            }
+        });
+        return res;
+    }
+
+    // answer queries in order, one JSON line each
+    void answerQueries(vector<DraftQuery> &queries, ostream &out) {
+        vector<int> bestIds = getBestIds(queries);
+        for(int k = 0; k < (int) queries.size(); k++) {
+            out << "{\"input\": " << queries[k].tag;
+            if(queries[k].error.empty()) {
+                out << ", \"best_id\": " << bestIds[k];
+            }
+            else {
+                out << ", \"error\": " << jsonString(queries[k].error);
+            }
+            out << "}\n";
+        }
+        out.flush();
+    }
+
+private:
+    int numWorkers;
+    map< string, unique_ptr<DraftEngine> > engines; // by algorithm line
+
+    DraftEngine* getEngine(const string &algorithm) {
+        auto found = engines.find(algorithm);
+        if(found != engines.end()) {
+            return found->second.get();
+        }
+        SearchMode mode;
+        SearchOptions options;
+        parseAlgorithm(algorithm, mode, options);
+        DraftEngine *engine = new DraftEngine(mode, options);
+        engines[algorithm] = unique_ptr<DraftEngine>(engine);
+        return engine;
+    }
+};
+
+// answer a JSONL stream of queries ("-" for stdin) a chunk at a time, so
+// that answers come out while the stream is still being read. Queries
+// without an algorithm use defaultAlgorithm, and those without an id are
+// tagged with their line number.
+void runJsonl(string path, string defaultAlgorithm, int numWorkers) {
+    ifstream file;
+    if(path != "-") {
+        file.open(path);
+        if(!file) {
+            throw invalid_argument("cannot open " + path + ".");
+        }
+    }
+    istream &in = (path == "-") ? cin : file;
+    const int CHUNK_SIZE = 1024;
+    DraftService service(numWorkers);
+    vector<DraftQuery> queries;
+    string line;
+    int lineNumber = 0;
+    while(getline(in, line)) {
+        lineNumber++;
+        if(line.find_first_not_of(" \t\r") == string::npos) {
+            continue;
+        }
+        DraftQuery query;
+        query.tag = to_string(lineNumber);
+        query.algorithm = defaultAlgorithm;
+        try {
+            QueryParser(line).parse(query.players, query.algorithm, query.tag);
+        }
+        catch(const exception &e) {
+            query.error = e.what();
+        }
+        queries.push_back(query);
+        if(queries.size() == CHUNK_SIZE) {
+            service.answerQueries(queries, cout);
+            queries.clear();
+        }
+    }
+    service.answerQueries(queries, cout);
+}
+
+// answer input files in the format of input.txt, each with its own
+// algorithm line
+void runInputs(const vector<string> &paths, int numWorkers) {
+    DraftService service(numWorkers);
+    vector<DraftQuery> queries;
+    for(string path : paths) {
+        DraftQuery query;
+        query.tag = jsonString(path);
+        ifstream fin(path);
+        if(!fin) {
+            query.error = "cannot open " + path + ".";
+        }
+        else {
+            readInput(fin, query.algorithm, query.players);
+        }
+        queries.push_back(query);
+    }
+    service.answerQueries(queries, cout);
+}
+
+int main(int argc, char *argv[]) {
+    string jsonlPath;
+    vector<string> inputPaths;
+    string defaultAlgorithm = "ab";
+    int numWorkers = 0;
+    for(int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if(arg == "--jsonl" && i + 1 < argc) {
+            jsonlPath = argv[++i];
+        }
+        else if(arg == "--algorithm" && i + 1 < argc) {
+            defaultAlgorithm = argv[++i];
+        }
+        else if(arg == "--threads" && i + 1 < argc) {
+            numWorkers = stoi(argv[++i]);
+        }
+        else if(arg.compare(0, 2, "--") != 0) {
+            inputPaths.push_back(arg);
+        }
+        else {
+            cerr << "usage: " << argv[0] << " [--jsonl <file or -> [--algorithm <algorithm line>]]"
+                 << " [--threads <n>] [<input file>...]" << endl;
+            return 1;
+        }
+    }
+    if(!jsonlPath.empty() || !inputPaths.empty()) {
+        ios::sync_with_stdio(false);
+        if(!jsonlPath.empty()) {
+            runJsonl(jsonlPath, defaultAlgorithm, numWorkers);
+        }
+        if(!inputPaths.empty()) {
+            runInputs(inputPaths, numWorkers);
+        }
+        return 0;
+    }
+
+    ifstream fin("input.txt");
+    string algorithm;
+    vector<Player> players;
+    readInput(fin, algorithm, players);
     fin.close();
 
-    int result = alphabeta(-INFINITY, INFINITY, true).first;
+    SearchMode mode;
+    SearchOptions options;
+    parseAlgorithm(algorithm, mode, options);
+    DraftEngine engine(mode, options);
+    int result = engine.getBestId(players);
     ofstream fout("output.txt");
     fout << result << endl;
     fout.close();
 
     return 0;
-}
\ No newline at end of file
+}